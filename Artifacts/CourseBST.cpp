@@ -10,6 +10,9 @@
 #include <algorithm>
 #include <sstream>
 #include <string>
+#include <cstdint>
+// Shared with the capstone, build with its StringPool.cpp
+#include "../Capstone/CharacterDatabase/CharacterDatabase/StringPool.h"
 
 //============================================================================
 // Global definitions visible to all methods and classes
@@ -17,12 +20,12 @@
 
 // Structure to represent a course
 struct Course {
-	// Course Identifier
-	std::string courseNumber;
+	// Course Identifier, id in the tree's course number pool
+	StringId courseNumber = 0;
 	// Course Title
 	std::string courseTitle;
-	// List of Prerequisites
-	std::vector<std::string> prerequisites;
+	// List of Prerequisites, ids in the same pool
+	std::vector<StringId> prerequisites;
 
 };
 
@@ -43,6 +46,20 @@ struct TreeNode {
 class CourseBST {
 private:
 	TreeNode* root;
+	// Course numbers and prerequisites, so equal numbers are equal ids
+	StringPool courseNumbers;
+	// First node for each course number id
+	std::vector<TreeNode*> nodeByNumber;
+
+	/*
+	* Whether course number a sorts before b
+	* 
+	* @param a - Id of a course number
+	* @param b - Id of a course number
+	*/
+	bool numberLess(StringId a, StringId b) const {
+		return courseNumbers.text(a) < courseNumbers.text(b);
+	}
 
 	/*
 	* Recursively insert a course into the BST
@@ -54,9 +71,11 @@ private:
 		// Insert Node here
 		if (!node) {
 			node = new TreeNode(course);
+			if (nodeByNumber.size() <= course.courseNumber) nodeByNumber.resize(course.courseNumber + 1, nullptr);
+			if (!nodeByNumber[course.courseNumber]) nodeByNumber[course.courseNumber] = node;
 		}
 		// Traverse Left
-		else if (course.courseNumber < node->course.courseNumber) {
+		else if (numberLess(course.courseNumber, node->course.courseNumber)) {
 			insertNode(node->left, course);
 		}
 		// Traverse Right
@@ -73,7 +92,7 @@ private:
 	void printInOrder(TreeNode* node) {
 		if (!node) return;
 		printInOrder(node->left);
-		std::cout << node->course.courseNumber << ": " << node->course.courseTitle << std::endl;
+		std::cout << courseNumbers.text(node->course.courseNumber) << ": " << node->course.courseTitle << std::endl;
 		printInOrder(node->right);
 	}
 
@@ -86,8 +105,9 @@ private:
 	*/
 	Course* find(TreeNode* node, const std::string& courseNumber) {
 		if (!node) return nullptr;
-		if (courseNumber == node->course.courseNumber) return &node->course;
-		if (courseNumber < node->course.courseNumber) return find(node->left, courseNumber);
+		const std::string& nodeNumber = courseNumbers.text(node->course.courseNumber);
+		if (courseNumber == nodeNumber) return &node->course;
+		if (courseNumber < nodeNumber) return find(node->left, courseNumber);
 		return find(node->right, courseNumber);
 
 	}
@@ -121,16 +141,157 @@ public:
 		return find(root, courseNumber);
 	}
 
+	/*
+	* Find a course by the id of its number, without comparing text
+	* 
+	* @param courseNumber - Id in this tree's course number pool
+	* @return Pointer to the course
+	*/
+	Course* findCourse(StringId courseNumber) {
+		if (courseNumber >= nodeByNumber.size() || !nodeByNumber[courseNumber]) return nullptr;
+		return &nodeByNumber[courseNumber]->course;
+	}
+
+	/*
+	* Pool the tree's course numbers and prerequisites are interned in
+	*/
+	StringPool& numbers() {
+		return courseNumbers;
+	}
+};
+
+// Structure for a compact tree node, children are slot numbers
+struct CompactTreeNode {
+	Course course;
+	uint32_t left;
+	uint32_t right;
+
+	//Constructor
+	CompactTreeNode(Course c) : course(c), left(noChild), right(noChild) {}
+
+	static constexpr uint32_t noChild = UINT32_MAX;
+};
+
+//============================================================================
+// Compact Course Binary Search Tree class definition
+// Nodes sit in one vector and link by 32 bit slot numbers, so a node has
+// 8 bytes of links instead of 16 plus its own heap allocation, and the
+// whole tree can be copied or moved without fixing up any links.
+// Course pointers are only good until the next insert.
+//============================================================================
+class CompactCourseBST {
+private:
+	std::vector<CompactTreeNode> nodes;
+	uint32_t root;
+	// Course numbers and prerequisites, so equal numbers are equal ids
+	StringPool courseNumbers;
+	// First slot for each course number id
+	std::vector<uint32_t> slotByNumber;
+
+	/*
+	* Whether course number a sorts before b
+	* 
+	* @param a - Id of a course number
+	* @param b - Id of a course number
+	*/
+	bool numberLess(StringId a, StringId b) const {
+		return courseNumbers.text(a) < courseNumbers.text(b);
+	}
+
+	/*
+	* Iteratively insert a course into the tree, equal numbers go right
+	* 
+	* @param course - Course to insert
+	*/
+	void insertNode(Course course) {
+		uint32_t slot = static_cast<uint32_t>(nodes.size());
+		uint32_t* link = &root;
+		while (*link != CompactTreeNode::noChild) {
+			CompactTreeNode& node = nodes[*link];
+			link = numberLess(course.courseNumber, node.course.courseNumber) ? &node.left : &node.right;
+		}
+		// Store the slot before push_back can move the vector
+		*link = slot;
+		if (slotByNumber.size() <= course.courseNumber) slotByNumber.resize(course.courseNumber + 1, CompactTreeNode::noChild);
+		if (slotByNumber[course.courseNumber] == CompactTreeNode::noChild) slotByNumber[course.courseNumber] = slot;
+		nodes.push_back(CompactTreeNode(course));
+	}
+
+	/*
+	* Recursively print courses in in-order traversal
+	* 
+	* @param slot - Current node in the tree
+	*/
+	void printInOrder(uint32_t slot) {
+		if (slot == CompactTreeNode::noChild) return;
+		printInOrder(nodes[slot].left);
+		std::cout << courseNumbers.text(nodes[slot].course.courseNumber) << ": " << nodes[slot].course.courseTitle << std::endl;
+		printInOrder(nodes[slot].right);
+	}
+public:
+	// Constructor
+	CompactCourseBST() : root(CompactTreeNode::noChild) {}
+
+	/*
+	* Insert a course into the tree
+	* 
+	* @param course - the course that is inserted
+	*/
+	void insert(Course course) {
+		insertNode(course);
+	}
+
+	/*
+	* Print all courses in sorted order 
+	*/
+	void printAllCourses() {
+		printInOrder(root);
+	}
 
+	/*
+	* Find and return a course by its number.
+	* 
+	* @param courseNumber - The course number
+	* @return Pointer to the course
+	*/
+	Course* findCourse(const std::string& courseNumber) {
+		uint32_t slot = root;
+		while (slot != CompactTreeNode::noChild) {
+			CompactTreeNode& node = nodes[slot];
+			const std::string& nodeNumber = courseNumbers.text(node.course.courseNumber);
+			if (courseNumber == nodeNumber) return &node.course;
+			slot = courseNumber < nodeNumber ? node.left : node.right;
+		}
+		return nullptr;
+	}
+
+	/*
+	* Find a course by the id of its number, without comparing text
+	* 
+	* @param courseNumber - Id in this tree's course number pool
+	* @return Pointer to the course
+	*/
+	Course* findCourse(StringId courseNumber) {
+		if (courseNumber >= slotByNumber.size() || slotByNumber[courseNumber] == CompactTreeNode::noChild) return nullptr;
+		return &nodes[slotByNumber[courseNumber]].course;
+	}
+
+	/*
+	* Pool the tree's course numbers and prerequisites are interned in
+	*/
+	StringPool& numbers() {
+		return courseNumbers;
+	}
 };
 
 /*
 * Load course data from a CSV file and insert into the BST.
 * 
 * @param filename - Path to the CSV file
-* @param bst - Reference to the CourseBST to populate
+* @param bst - Reference to the CourseBST or CompactCourseBST to populate
 */
-void loadCoursesFromFile(const std::string& filename, CourseBST& bst) {
+template <typename Tree>
+void loadCoursesFromFile(const std::string& filename, Tree& bst) {
 	std::ifstream file(filename);
 	if (!file.is_open()) {
 		std::cout << "Error: File could not be opened." << std::endl;
@@ -144,7 +305,7 @@ void loadCoursesFromFile(const std::string& filename, CourseBST& bst) {
 		Course course;
 		// Read course number
 		if (!std::getline(ss, token, ',')) continue;
-		course.courseNumber = token;
+		course.courseNumber = bst.numbers().intern(token);
 
 		// Read course title
 		if (!std::getline(ss, token, ',')) continue;
@@ -152,7 +313,7 @@ void loadCoursesFromFile(const std::string& filename, CourseBST& bst) {
 		
 		// Read prerequisites, remaining tokens
 		while (getline(ss, token, ',')) {
-			course.prerequisites.push_back(token);
+			course.prerequisites.push_back(bst.numbers().intern(token));
 		}
 
 		//Insert the course into BST
@@ -164,10 +325,11 @@ void loadCoursesFromFile(const std::string& filename, CourseBST& bst) {
 /*
 * Print information about a specific course and its prerequisites
 * 
-* @param bst - Reference to the CourseBST to populate
+* @param bst - Reference to the CourseBST or CompactCourseBST to search
 * @param courseNumber - The course number
 */
-void printCourseInfo(CourseBST& bst, const std::string& courseNumber) {
+template <typename Tree>
+void printCourseInfo(Tree& bst, const std::string& courseNumber) {
 	Course* course = bst.findCourse(courseNumber);
 	// If courses not found
 	if (!course) {
@@ -175,7 +337,8 @@ void printCourseInfo(CourseBST& bst, const std::string& courseNumber) {
 		return;
 	}
 
-	std::cout << "\nCourse Number: " << course->courseNumber << std::endl;
+	const StringPool& numbers = bst.numbers();
+	std::cout << "\nCourse Number: " << numbers.text(course->courseNumber) << std::endl;
 	std::cout << "Course Title: " << course->courseTitle << std::endl;
 
 	//Print Prerequisites
@@ -185,13 +348,13 @@ void printCourseInfo(CourseBST& bst, const std::string& courseNumber) {
 	}
 	else {
 		std::cout << "Prerequisites: " << std::endl;
-		for (const std::string& prereq : course->prerequisites) {
+		for (StringId prereq : course->prerequisites) {
 			Course* prereqCourse = bst.findCourse(prereq);
 			if (prereqCourse) {
-				std::cout << "- " << prereqCourse->courseNumber << ": " << prereqCourse->courseTitle << std::endl;
+				std::cout << "- " << numbers.text(prereq) << ": " << prereqCourse->courseTitle << std::endl;
 			}
 			else {
-				std::cout << "- " << prereq << " (Not Found)" << std::endl;
+				std::cout << "- " << numbers.text(prereq) << " (Not Found)" << std::endl;
 			}
 		}
 	}
@@ -201,7 +364,7 @@ void printCourseInfo(CourseBST& bst, const std::string& courseNumber) {
 // Main Method
 //============================================================================
 int main() {
-	CourseBST bst;
+	CompactCourseBST bst;
 	std::string filename = "Test.csv";
 	bool dataloaded = false;
 
@@ -12,51 +12,196 @@
 // ===========================================================
 
 #include "Character.h"
+#include "SpscQueue.h"
+#include "OperationLog.h"
+#include "PersistentCharacterBST.h"
+#include "CharacterSkipList.h"
+#include "CharacterSplitBST.h"
+#include "CharacterBPlusTree.h"
+#include "FrozenCharacterIndex.h"
+#include "CharacterRadixTree.h"
+#include "CompactCharacterBST.h"
 #include <fstream>
 #include <sstream>
 #include <sqlite3.h>
 #include <stdexcept>
+#include <thread>
+#include <queue>
+#include <algorithm>
+#include <exception>
+#include <cstring>
+#include <cstdint>
 
-//Constructor for a node that wraps a character
-Node::Node(Character c) : data(c), left(nullptr), right(nullptr) {}
+//======================================
+//		Field Masks
+//======================================
+uint32_t changedFields(const Character& a, const Character& b, uint32_t fields) {
+	uint32_t changed = 0;
+	if ((fields & CharacterField::Ability1) && a.ability1 != b.ability1) changed |= CharacterField::Ability1;
+	if ((fields & CharacterField::Ability2) && a.ability2 != b.ability2) changed |= CharacterField::Ability2;
+	if ((fields & CharacterField::Ability3) && a.ability3 != b.ability3) changed |= CharacterField::Ability3;
+	if ((fields & CharacterField::Ability4) && a.ability4 != b.ability4) changed |= CharacterField::Ability4;
+	if ((fields & CharacterField::GunDPS) && a.gunDPS != b.gunDPS) changed |= CharacterField::GunDPS;
+	if ((fields & CharacterField::BulletDMG) && a.bulletDMG != b.bulletDMG) changed |= CharacterField::BulletDMG;
+	if ((fields & CharacterField::Ammo) && a.ammo != b.ammo) changed |= CharacterField::Ammo;
+	if ((fields & CharacterField::BulletSpeed) && a.bulletSpeed != b.bulletSpeed) changed |= CharacterField::BulletSpeed;
+	if ((fields & CharacterField::LightMeleeDMG) && a.lightMeleeDMG != b.lightMeleeDMG) changed |= CharacterField::LightMeleeDMG;
+	if ((fields & CharacterField::HeavyMeleeDMG) && a.heavyMeleeDMG != b.heavyMeleeDMG) changed |= CharacterField::HeavyMeleeDMG;
+	if ((fields & CharacterField::Health) && a.health != b.health) changed |= CharacterField::Health;
+	if ((fields & CharacterField::Regen) && a.regen != b.regen) changed |= CharacterField::Regen;
+	if ((fields & CharacterField::BulletResist) && a.bulletResist != b.bulletResist) changed |= CharacterField::BulletResist;
+	if ((fields & CharacterField::SpiritResist) && a.spiritResist != b.spiritResist) changed |= CharacterField::SpiritResist;
+	if ((fields & CharacterField::Speed) && a.speed != b.speed) changed |= CharacterField::Speed;
+	if ((fields & CharacterField::Sprint) && a.sprint != b.sprint) changed |= CharacterField::Sprint;
+	if ((fields & CharacterField::Stamina) && a.stamina != b.stamina) changed |= CharacterField::Stamina;
+	return changed;
+}
+
+void copyFields(Character& to, const Character& from, uint32_t fields) {
+	if (fields & CharacterField::Ability1) to.ability1 = from.ability1;
+	if (fields & CharacterField::Ability2) to.ability2 = from.ability2;
+	if (fields & CharacterField::Ability3) to.ability3 = from.ability3;
+	if (fields & CharacterField::Ability4) to.ability4 = from.ability4;
+	if (fields & CharacterField::GunDPS) to.gunDPS = from.gunDPS;
+	if (fields & CharacterField::BulletDMG) to.bulletDMG = from.bulletDMG;
+	if (fields & CharacterField::Ammo) to.ammo = from.ammo;
+	if (fields & CharacterField::BulletSpeed) to.bulletSpeed = from.bulletSpeed;
+	if (fields & CharacterField::LightMeleeDMG) to.lightMeleeDMG = from.lightMeleeDMG;
+	if (fields & CharacterField::HeavyMeleeDMG) to.heavyMeleeDMG = from.heavyMeleeDMG;
+	if (fields & CharacterField::Health) to.health = from.health;
+	if (fields & CharacterField::Regen) to.regen = from.regen;
+	if (fields & CharacterField::BulletResist) to.bulletResist = from.bulletResist;
+	if (fields & CharacterField::SpiritResist) to.spiritResist = from.spiritResist;
+	if (fields & CharacterField::Speed) to.speed = from.speed;
+	if (fields & CharacterField::Sprint) to.sprint = from.sprint;
+	if (fields & CharacterField::Stamina) to.stamina = from.stamina;
+}
+
+CharacterStats statsOf(const Character& c) {
+	return { c.gunDPS, c.bulletDMG, c.ammo, c.bulletSpeed, c.lightMeleeDMG, c.heavyMeleeDMG,
+		c.health, c.regen, c.bulletResist, c.spiritResist, c.speed, c.sprint, c.stamina };
+}
+
+void setStats(Character& c, const CharacterStats& s) {
+	c.gunDPS = s.gunDPS;
+	c.bulletDMG = s.bulletDMG;
+	c.ammo = s.ammo;
+	c.bulletSpeed = s.bulletSpeed;
+	c.lightMeleeDMG = s.lightMeleeDMG;
+	c.heavyMeleeDMG = s.heavyMeleeDMG;
+	c.health = s.health;
+	c.regen = s.regen;
+	c.bulletResist = s.bulletResist;
+	c.spiritResist = s.spiritResist;
+	c.speed = s.speed;
+	c.sprint = s.sprint;
+	c.stamina = s.stamina;
+}
+
+uint64_t namePrefix(const std::string& name) {
+	uint64_t key = 0;
+	size_t n = name.size() < 8 ? name.size() : 8;
+	for (size_t i = 0; i < n; ++i) key |= uint64_t(static_cast<unsigned char>(name[i])) << (56 - 8 * i);
+	return key;
+}
+
+//======================================
+//		Throwing Index Functions
+//		Messages are built only once a change failed
+//======================================
+static std::runtime_error insertError(const std::string& name) {
+	return std::runtime_error("Insert failed: Character with name '" + name + "' already exists.");
+}
+static std::runtime_error updateError(const std::string& name) {
+	return std::runtime_error("Update failed: Character '" + name + "' not found.");
+}
+static std::runtime_error renameError(const std::string& name) {
+	return std::runtime_error("Update failed: cannot rename '" + name + "', delete it and add the new name.");
+}
+static std::runtime_error deleteError(const std::string& name) {
+	return std::runtime_error("Delete failed: Character '" + name + "' not found.");
+}
+
+// Loader warning for a duplicate row
+static void warnDuplicate(const std::string& name) {
+	std::cerr << "Warning: Insert failed: Character with name '" << name
+		<< "' already exists. Skipping duplicate in BST.\n";
+}
+
+void CharacterIndex::insert(const Character& c) {
+	if (tryInsert(c) != CrudStatus::Ok) throw insertError(c.name);
+}
+void CharacterIndex::insert(Character&& c) {
+	if (tryInsert(std::move(c)) != CrudStatus::Ok) throw insertError(c.name);
+}
+void CharacterIndex::update(const std::string& name, const Character& updated) {
+	if (tryUpdate(name, updated) != CrudStatus::Ok) throw updateError(name);
+	std::cout << "updated: " + name;
+}
+void CharacterIndex::remove(const std::string& name) {
+	if (tryRemove(name) != CrudStatus::Ok) throw deleteError(name);
+	std::cout << "removed: " + name;
+}
+
+void CharacterIndex::forEachWithPrefix(const std::string& prefix, const std::function<void(const Character&)>& fn) const {
+	forEachInOrder([&](const Character& c) {
+		if (c.name.compare(0, prefix.size(), prefix) == 0) fn(c);
+		});
+}
+
+//Constructors for a node that wraps a character
+Node::Node(const Character& c) : prefix(namePrefix(c.name)), left(nullptr), right(nullptr), data(c) {}
+Node::Node(Character&& c) : prefix(namePrefix(c.name)), left(nullptr), right(nullptr), data(std::move(c)) {}
 
 //Constructor and destructor
-CharacterBST::CharacterBST() : root(nullptr) {}
+CharacterBST::CharacterBST() : root(nullptr), count(0) {}
 CharacterBST::~CharacterBST() { destroy(root); }
 
 //======================================
 //			BST Insert
 //======================================
-Node* CharacterBST::insert(Node* node, const Character& c) {
-	//Empty Spot Create node
-	if (!node) return new Node(c);
-	//Go left if smaller
-	if (c.name < node->data.name) {
-		node->left = insert(node->left, c);
-	} 
-	// Go right if larger
-	else if (c.name > node->data.name) {
-		node->right = insert(node->right, c);
-	}
-	else {
-		// Catch duplicate names
-		throw std::runtime_error("Insert failed: Character with name '" + c.name + "' already exists.");
 
+// Walks down to the empty link, one compare per level
+Node** CharacterBST::insertLink(const std::string& name) {
+	const uint64_t key = namePrefix(name);
+	Node** link = &root;
+	while (*link) {
+		int cmp = (*link)->compare(name, key);
+		if (cmp == 0) return nullptr;
+		link = cmp < 0 ? &(*link)->left : &(*link)->right;
 	}
-	return node;
+	return link;
+}
+
+// Duplicate names are reported, not thrown
+CrudStatus CharacterBST::tryInsert(const Character& c) {
+	Node** link = insertLink(c.name);
+	if (!link) return CrudStatus::Duplicate;
+	*link = pool.create(c);
+	++count;
+	return CrudStatus::Ok;
+}
+
+CrudStatus CharacterBST::tryInsert(Character&& c) {
+	Node** link = insertLink(c.name);
+	if (!link) return CrudStatus::Duplicate;
+	*link = pool.create(std::move(c));
+	++count;
+	return CrudStatus::Ok;
 }
 //======================================
 //			BST Search
 //======================================
-Node* CharacterBST::search(Node* node, const std::string& name) {
-	//Base Case
-	if (!node) return nullptr;
-	//Found
-	if (name == node->data.name) return node;
-	// Search Left
-	if (name < node->data.name) return search(node->left, name);
-	// Search Right
-	return search(node->right, name);
+Node* CharacterBST::search(Node* node, const std::string& name) const {
+	const uint64_t key = namePrefix(name);
+	while (node) {
+		int cmp = node->compare(name, key);
+		//Found
+		if (cmp == 0) return node;
+		// Search Left or Right
+		node = cmp < 0 ? node->left : node->right;
+	}
+	return nullptr;
 }
 
 //======================================
@@ -74,46 +219,43 @@ void CharacterBST::inorder(Node* node) {
 	}
 }
 
-// Helper to find leftmost node
-Node* CharacterBST::findMin(Node* node) {
-	while (node && node->left) node = node->left;
-	return node;
-}
+//======================================
+//			BST Remove
+//======================================
 
-// Recursive remover
-Node* CharacterBST::remove(Node* node, const std::string& name) {
-	if (!node) return nullptr;
+// Finds the parent link in one descent and unlinks the node there
+CrudStatus CharacterBST::tryRemove(const std::string& name) {
+	const uint64_t key = namePrefix(name);
+	Node** link = &root;
+	while (*link) {
+		int cmp = (*link)->compare(name, key);
+		if (cmp == 0) break;
+		link = cmp < 0 ? &(*link)->left : &(*link)->right;
+	}
+	Node* node = *link;
+	if (!node) return CrudStatus::NotFound;
 
-	if (name < node->data.name) {
-		node->left = remove(node->left, name);
+	// Zero or one child: the child takes its place
+	if (!node->left) {
+		*link = node->right;
 	}
-	else if (name > node->data.name) {
-		node->right = remove(node->right, name);
+	else if (!node->right) {
+		*link = node->left;
 	}
 	else {
-		// Node found: 3 cases
-		if (!node->left && !node->right) {
-			delete node;
-			return nullptr;
-		}
-		else if (!node->left) {
-			Node* temp = node->right;
-			delete node;
-			return temp;
-		}
-		else if (!node->right) {
-			Node* temp = node->left;
-			delete node;
-			return temp;
-		}
-		else {
-			// Two children: replace with inorder successor (min in right subtree)
-			Node* minRight = findMin(node->right);
-			node->data = minRight->data;
-			node->right = remove(node->right, minRight->data.name);
-		}
+		// Two children: the inorder successor (min in right subtree) is
+		// unhooked and relinked in the node's place, no record is moved
+		Node** minLink = &node->right;
+		while ((*minLink)->left) minLink = &(*minLink)->left;
+		Node* minRight = *minLink;
+		*minLink = minRight->right;
+		minRight->left = node->left;
+		minRight->right = node->right;
+		*link = minRight;
 	}
-	return node;
+	pool.destroy(node);
+	--count;
+	return CrudStatus::Ok;
 }
 
 //Recursive destructor helper
@@ -121,22 +263,34 @@ void CharacterBST::destroy(Node* node) {
 	if (node) {
 		destroy(node->left);
 		destroy(node->right);
-		delete node;
+		pool.destroy(node);
 	}
 }
 
+// Recursive balanced builder, middle record becomes the subtree root
+Node* CharacterBST::buildBalanced(std::vector<Character>& sorted, size_t lo, size_t hi) {
+	if (lo >= hi) return nullptr;
+	size_t mid = lo + (hi - lo) / 2;
+	Node* node = pool.create(std::move(sorted[mid]));
+	node->left = buildBalanced(sorted, lo, mid);
+	node->right = buildBalanced(sorted, mid + 1, hi);
+	return node;
+}
+
 
 
 //======================================
 //		 Public BST Functions
 //======================================
-void CharacterBST::insert(const Character& c) { root = insert(root, c); }
-
 // BST Search
 Character* CharacterBST::search(const std::string& name) {
 	Node* result = search(root, name);
 	return result ? &result->data : nullptr;
 }
+const Character* CharacterBST::search(const std::string& name) const {
+	Node* result = search(root, name);
+	return result ? &result->data : nullptr;
+}
 
 //BST Display all
 void CharacterBST::displayAll() {
@@ -148,27 +302,207 @@ void CharacterBST::displayAll() {
 }
 
 //BST Update
-void CharacterBST::update(const std::string& name, const Character& updated) {
+CrudStatus CharacterBST::tryUpdate(const std::string& name, const Character& updated) {
 	Node* node = search(root, name);
-	if (!node) {
-		throw std::runtime_error("Update failed: Character '" + name + "' not found.");
-	}
+	if (!node) return CrudStatus::NotFound;
 	node->data = updated;
-	std::cout << "updated: " + name;
+	node->prefix = namePrefix(node->data.name);
+	return CrudStatus::Ok;
+}
+
+//BST Patch in place
+CrudStatus CharacterBST::tryPatch(const std::string& name, const std::function<void(Character&)>& mutator) {
+	Node* node = search(root, name);
+	if (!node) return CrudStatus::NotFound;
+	mutator(node->data);
+	node->prefix = namePrefix(node->data.name);
+	return CrudStatus::Ok;
 }
-//BST Remove
-void CharacterBST::remove(const std::string& name) {
-	if (!search(root, name)) {
-		throw std::runtime_error("Delete failed: Character '" + name + "' not found.");
+
+//BST Copy out
+bool CharacterBST::lookup(const std::string& name, Character& out) const {
+	Node* node = search(root, name);
+	if (!node) return false;
+	out = node->data;
+	return true;
+}
+
+//BST Visit one record
+bool CharacterBST::visit(const std::string& name, const std::function<void(const Character&)>& fn) const {
+	Node* node = search(root, name);
+	if (!node) return false;
+	fn(node->data);
+	return true;
+}
+
+//BST In order visit
+void CharacterBST::inorder(const Node* node, const std::function<void(const Character&)>& fn) const {
+	if (!node) return;
+	inorder(node->left, fn);
+	fn(node->data);
+	inorder(node->right, fn);
+}
+void CharacterBST::forEachInOrder(const std::function<void(const Character&)>& fn) const {
+	inorder(root, fn);
+}
+
+//BST Clear
+void CharacterBST::clear() {
+	destroy(root);
+	root = nullptr;
+	count = 0;
+}
+
+//BST Build from sorted records
+void CharacterBST::buildFromSorted(std::vector<Character>& sorted) {
+	if (root) {
+		throw std::runtime_error("Build failed: tree is not empty.");
 	}
-	root = remove(root, name);
-	std::cout << "removed: " + name;
+	root = buildBalanced(sorted, 0, sorted.size());
+	count = sorted.size();
 }
 
 //======================================
 //	CharacterDatabase Implementation
 //======================================
 
+// Schema shared by every loader
+static const char* createTableSQL =
+	"CREATE TABLE IF NOT EXISTS Characters ("
+	"Name TEXT PRIMARY KEY, "
+	"Ability1 TEXT, Ability2 TEXT, Ability3 TEXT, Ability4 TEXT, "
+	"DPS REAL, BulletDMG REAL, Ammo INTEGER, BulletPS REAL, "
+	"LightMelee INTEGER, HeavyMelee INTEGER, "
+	"MaxHealth INTEGER, HealthRegen REAL, BulletResist REAL, SpiritResist REAL, "
+	"MoveSpeed REAL, SprintSpeed REAL, Stamina INTEGER);";
+
+// Column list shared by every loader, Name is always column 0
+#define CHARACTER_COLUMNS "Name, Ability1, Ability2, Ability3, Ability4, " \
+	"DPS, BulletDMG, Ammo, BulletPS, LightMelee, HeavyMelee, " \
+	"MaxHealth, HealthRegen, BulletResist, SpiritResist, MoveSpeed, SprintSpeed, Stamina"
+
+// Schema version 2 keeps the classic columns and adds the numeric
+// stats packed into one BLOB so loaders decode a single column.
+// The classic columns follow so a NULL BLOB falls back to them.
+#define PACKED_CHARACTER_COLUMNS CHARACTER_COLUMNS ", Stats"
+static const int packedStatsVersion = 2;
+
+// Writes through the classic columns that leave Stats untouched
+// clear it, so a stale BLOB is never read in place of them
+static const char* staleStatsTriggerSQL =
+	"CREATE TRIGGER IF NOT EXISTS ClearStaleStats "
+	"AFTER UPDATE OF DPS, BulletDMG, Ammo, BulletPS, LightMelee, HeavyMelee, "
+	"MaxHealth, HealthRegen, BulletResist, SpiritResist, MoveSpeed, SprintSpeed, Stamina "
+	"ON Characters WHEN NEW.Stats IS OLD.Stats "
+	"BEGIN UPDATE Characters SET Stats = NULL WHERE rowid = NEW.rowid; END;";
+
+// Fixed layout of the Stats BLOB, 13 4 byte fields in Character
+// order and host byte order. Written and read with one memcpy.
+struct PackedStats {
+	int32_t gunDPS;
+	float bulletDMG;
+	int32_t ammo;
+	float bulletSpeed;
+	int32_t lightMeleeDMG;
+	int32_t heavyMeleeDMG;
+	int32_t health;
+	float regen;
+	float bulletResist;
+	float spiritResist;
+	float speed;
+	float sprint;
+	int32_t stamina;
+};
+static_assert(sizeof(PackedStats) == 52, "PackedStats must stay 52 bytes");
+
+// Packs the numeric stats of a character
+static PackedStats packStats(const Character& c) {
+	PackedStats p;
+	p.gunDPS = c.gunDPS;
+	p.bulletDMG = c.bulletDMG;
+	p.ammo = c.ammo;
+	p.bulletSpeed = c.bulletSpeed;
+	p.lightMeleeDMG = c.lightMeleeDMG;
+	p.heavyMeleeDMG = c.heavyMeleeDMG;
+	p.health = c.health;
+	p.regen = c.regen;
+	p.bulletResist = c.bulletResist;
+	p.spiritResist = c.spiritResist;
+	p.speed = c.speed;
+	p.sprint = c.sprint;
+	p.stamina = c.stamina;
+	return p;
+}
+
+// Reads the schema version stored in PRAGMA user_version
+static int schemaVersion(sqlite3* db) {
+	sqlite3_stmt* stmt;
+	int version = 0;
+	if (sqlite3_prepare_v2(db, "PRAGMA user_version;", -1, &stmt, nullptr) == SQLITE_OK) {
+		if (sqlite3_step(stmt) == SQLITE_ROW) version = sqlite3_column_int(stmt, 0);
+		sqlite3_finalize(stmt);
+	}
+	return version;
+}
+
+// Copies a text column using its stored length, NULL becomes empty
+static std::string columnString(sqlite3_stmt* stmt, int col) {
+	const char* text = reinterpret_cast<const char*>(sqlite3_column_text(stmt, col));
+	if (!text) return std::string();
+	return std::string(text, static_cast<size_t>(sqlite3_column_bytes(stmt, col)));
+}
+
+// Decodes the current row of a statement selecting CHARACTER_COLUMNS
+// (or PACKED_CHARACTER_COLUMNS when packed) starting at column "first".
+// Rows added through the classic columns have a NULL Stats BLOB.
+static Character readCharacterRow(sqlite3_stmt* stmt, int first, bool packed) {
+	Character c;
+	c.name = columnString(stmt, first + 0);
+	c.ability1 = columnString(stmt, first + 1);
+	c.ability2 = columnString(stmt, first + 2);
+	c.ability3 = columnString(stmt, first + 3);
+	c.ability4 = columnString(stmt, first + 4);
+
+	if (packed && sqlite3_column_type(stmt, first + 18) != SQLITE_NULL) {
+		PackedStats p;
+		const void* blob = sqlite3_column_blob(stmt, first + 18);
+		if (!blob || sqlite3_column_bytes(stmt, first + 18) != sizeof(PackedStats)) {
+			throw std::runtime_error("Corrupt packed stats for character '" + c.name + "'");
+		}
+		std::memcpy(&p, blob, sizeof(PackedStats));
+		c.gunDPS = p.gunDPS;
+		c.bulletDMG = p.bulletDMG;
+		c.ammo = p.ammo;
+		c.bulletSpeed = p.bulletSpeed;
+		c.lightMeleeDMG = p.lightMeleeDMG;
+		c.heavyMeleeDMG = p.heavyMeleeDMG;
+		c.health = p.health;
+		c.regen = p.regen;
+		c.bulletResist = p.bulletResist;
+		c.spiritResist = p.spiritResist;
+		c.speed = p.speed;
+		c.sprint = p.sprint;
+		c.stamina = p.stamina;
+		return c;
+	}
+
+	// Classic layout, integer stats read as integers
+	c.gunDPS = sqlite3_column_int(stmt, first + 5);
+	c.bulletDMG = static_cast<float>(sqlite3_column_double(stmt, first + 6));
+	c.ammo = sqlite3_column_int(stmt, first + 7);
+	c.bulletSpeed = static_cast<float>(sqlite3_column_double(stmt, first + 8));
+	c.lightMeleeDMG = sqlite3_column_int(stmt, first + 9);
+	c.heavyMeleeDMG = sqlite3_column_int(stmt, first + 10);
+	c.health = sqlite3_column_int(stmt, first + 11);
+	c.regen = static_cast<float>(sqlite3_column_double(stmt, first + 12));
+	c.bulletResist = static_cast<float>(sqlite3_column_double(stmt, first + 13));
+	c.spiritResist = static_cast<float>(sqlite3_column_double(stmt, first + 14));
+	c.speed = static_cast<float>(sqlite3_column_double(stmt, first + 15));
+	c.sprint = static_cast<float>(sqlite3_column_double(stmt, first + 16));
+	c.stamina = sqlite3_column_int(stmt, first + 17);
+	return c;
+}
+
 // Loads characters from SQLite3 Database
 void CharacterDatabase::loadFromDB(const std::string& dbFile) {
 	sqlite3* db;
@@ -181,23 +515,14 @@ void CharacterDatabase::loadFromDB(const std::string& dbFile) {
 	}
 
 	// If table does not exist create it
-	const char* createTableSQL =
-		"CREATE TABLE IF NOT EXISTS Characters ("
-		"Name TEXT PRIMARY KEY, "
-		"Ability1 TEXT, Ability2 TEXT, Ability3 TEXT, Ability4 TEXT, "
-		"DPS REAL, BulletDMG REAL, Ammo INTEGER, BulletPS REAL, "
-		"LightMelee INTEGER, HeavyMelee INTEGER, "
-		"MaxHealth INTEGER, HealthRegen REAL, BulletResist REAL, SpiritResist REAL, "
-		"MoveSpeed REAL, SprintSpeed REAL, Stamina INTEGER);";
-
 	rc = sqlite3_exec(db, createTableSQL, nullptr, nullptr, nullptr);
 	if (rc != SQLITE_OK) throw std::runtime_error("Failed to create table: " + std::string(sqlite3_errmsg(db)));
 
-	// Prepare Select Query
-	const char* sql = "SELECT Name, Ability1, Ability2, Ability3, Ability4, "
-		"DPS, BulletDMG, Ammo, BulletPS, LightMelee, HeavyMelee, "
-		"MaxHealth, HealthRegen, BulletResist, SpiritResist, MoveSpeed, SprintSpeed, Stamina "
-		" FROM Characters;";
+	// Prepare Select Query, packed layout when the schema has it
+	bool packed = schemaVersion(db) >= packedStatsVersion;
+	const char* sql = packed
+		? "SELECT " PACKED_CHARACTER_COLUMNS " FROM Characters;"
+		: "SELECT " CHARACTER_COLUMNS " FROM Characters;";
 
 	rc = sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr);
 	if (rc != SQLITE_OK) {
@@ -207,34 +532,21 @@ void CharacterDatabase::loadFromDB(const std::string& dbFile) {
 	}
 
 	//Loop through results and insert into BST
+	WriteGuard guard = lockForWrite();
 	while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
 		Character c;
-		c.name = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
-		c.ability1 = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
-		c.ability2 = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2));
-		c.ability3 = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 3));
-		c.ability4 = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 4));
-		c.gunDPS = static_cast<int>(sqlite3_column_double(stmt, 5));
-		c.bulletDMG = static_cast<float>(sqlite3_column_double(stmt, 6));
-		c.ammo = static_cast<int>(sqlite3_column_double(stmt, 7));
-		c.bulletSpeed = static_cast<float>(sqlite3_column_double(stmt, 8));
-		c.lightMeleeDMG = static_cast<int>(sqlite3_column_double(stmt, 9));
-		c.heavyMeleeDMG = static_cast<int>(sqlite3_column_double(stmt, 10));
-		c.health = static_cast<int>(sqlite3_column_double(stmt, 11));
-		c.regen = static_cast<float>(sqlite3_column_double(stmt, 12));
-		c.bulletResist = static_cast<float>(sqlite3_column_double(stmt, 13));
-		c.spiritResist = static_cast<float>(sqlite3_column_double(stmt, 14));
-		c.speed = static_cast<float>(sqlite3_column_double(stmt, 15));
-		c.sprint = static_cast<float>(sqlite3_column_double(stmt, 16));
-		c.stamina = static_cast<int>(sqlite3_column_double(stmt, 17));
-
 		try {
-			bst.insert(c);
+			c = readCharacterRow(stmt, 0, packed);
 		}
-		catch (std::exception& e) {
-			std::cerr << "Warning: " << e.what() << " Skipping duplicate in BST.\n";
+		catch (...) {
+			sqlite3_finalize(stmt);
+			sqlite3_close(db);
+			throw;
 		}
+
+		if (writable().tryInsert(std::move(c)) == CrudStatus::Duplicate) warnDuplicate(c.name);
 	}
+	republish();
 
 	//Check for errors
 	if (rc != SQLITE_DONE) {
@@ -248,11 +560,1086 @@ void CharacterDatabase::loadFromDB(const std::string& dbFile) {
 	sqlite3_close(db);
 }
 
+//======================================
+//	Packed Stats Schema Upgrade
+//======================================
+
+// Adds the Stats BLOB column, fills it from the classic columns and
+// marks the file as schema version 2. Classic columns stay readable
+// and writable, the trigger keeps Stats from going stale.
+void CharacterDatabase::upgradeToPackedStats(const std::string& dbFile) {
+	sqlite3* db;
+	sqlite3_stmt* select = nullptr;
+	sqlite3_stmt* update = nullptr;
+
+	int rc = sqlite3_open(dbFile.c_str(), &db);
+	if (rc != SQLITE_OK) {
+		std::string err = sqlite3_errmsg(db);
+		sqlite3_close(db);
+		throw std::runtime_error("Cannot Open Database: " + err);
+	}
+
+	// Cleans up and reports the current SQLite error
+	auto fail = [&](const std::string& what) {
+		std::string err = sqlite3_errmsg(db);
+		sqlite3_finalize(select);
+		sqlite3_finalize(update);
+		sqlite3_exec(db, "ROLLBACK;", nullptr, nullptr, nullptr);
+		sqlite3_close(db);
+		throw std::runtime_error(what + ": " + err);
+		};
+
+	if (sqlite3_exec(db, createTableSQL, nullptr, nullptr, nullptr) != SQLITE_OK) fail("Failed to create table");
+	// Files upgraded before the trigger existed still get it
+	if (schemaVersion(db) >= packedStatsVersion) {
+		if (sqlite3_exec(db, staleStatsTriggerSQL, nullptr, nullptr, nullptr) != SQLITE_OK) fail("Failed to create trigger");
+		sqlite3_close(db);
+		return;
+	}
+	if (sqlite3_exec(db, "BEGIN IMMEDIATE;", nullptr, nullptr, nullptr) != SQLITE_OK) fail("Failed to begin upgrade");
+
+	// Add the column unless an earlier interrupted upgrade already did
+	sqlite3_stmt* probe = nullptr;
+	if (sqlite3_prepare_v2(db, "SELECT Stats FROM Characters LIMIT 0;", -1, &probe, nullptr) != SQLITE_OK) {
+		if (sqlite3_exec(db, "ALTER TABLE Characters ADD COLUMN Stats BLOB;", nullptr, nullptr, nullptr) != SQLITE_OK) {
+			fail("Failed to add Stats column");
+		}
+	}
+	sqlite3_finalize(probe);
+
+	if (sqlite3_prepare_v2(db, "SELECT rowid, " CHARACTER_COLUMNS " FROM Characters;", -1, &select, nullptr) != SQLITE_OK ||
+		sqlite3_prepare_v2(db, "UPDATE Characters SET Stats = ?1 WHERE rowid = ?2;", -1, &update, nullptr) != SQLITE_OK) {
+		fail("Failed to prepare statement");
+	}
+
+	// Pack every row from its classic columns
+	while ((rc = sqlite3_step(select)) == SQLITE_ROW) {
+		PackedStats p = packStats(readCharacterRow(select, 1, false));
+		sqlite3_bind_blob(update, 1, &p, sizeof(PackedStats), SQLITE_TRANSIENT);
+		sqlite3_bind_int64(update, 2, sqlite3_column_int64(select, 0));
+		if (sqlite3_step(update) != SQLITE_DONE) fail("Failed to write packed stats");
+		sqlite3_reset(update);
+	}
+	if (rc != SQLITE_DONE) fail("Error Reading Database");
+
+	sqlite3_finalize(select);
+	sqlite3_finalize(update);
+	select = update = nullptr;
+
+	if (sqlite3_exec(db, staleStatsTriggerSQL, nullptr, nullptr, nullptr) != SQLITE_OK) fail("Failed to create trigger");
+	std::string version = "PRAGMA user_version = " + std::to_string(packedStatsVersion) + ";";
+	if (sqlite3_exec(db, version.c_str(), nullptr, nullptr, nullptr) != SQLITE_OK) fail("Failed to set schema version");
+	if (sqlite3_exec(db, "COMMIT;", nullptr, nullptr, nullptr) != SQLITE_OK) fail("Failed to commit upgrade");
+	sqlite3_close(db);
+}
+
+//======================================
+//	Parallel Partitioned Loading
+//======================================
+
+// Ties go to the lower run. Loader runs cover increasing rowid ranges
+// and keep table order per name, so the first row of a name wins just
+// as in the serial loader.
+std::vector<Character> mergeSortedRuns(std::vector<std::vector<Character>>& runs,
+	const std::function<void(const Character&)>& onDuplicate) {
+	typedef std::pair<size_t, size_t> Cursor; // run, position
+	auto later = [&](const Cursor& a, const Cursor& b) {
+		int order = runs[a.first][a.second].name.compare(runs[b.first][b.second].name);
+		if (order != 0) return order > 0;
+		return a.first > b.first;
+		};
+	std::priority_queue<Cursor, std::vector<Cursor>, decltype(later)> heap(later);
+	size_t total = 0;
+	for (size_t r = 0; r < runs.size(); ++r) {
+		total += runs[r].size();
+		if (!runs[r].empty()) heap.push(Cursor(r, 0));
+	}
+
+	std::vector<Character> sorted;
+	sorted.reserve(total);
+	while (!heap.empty()) {
+		Cursor top = heap.top();
+		heap.pop();
+		Character& c = runs[top.first][top.second];
+		if (!sorted.empty() && sorted.back().name == c.name) {
+			if (onDuplicate) onDuplicate(c);
+		}
+		else {
+			sorted.push_back(std::move(c));
+		}
+		if (top.second + 1 < runs[top.first].size()) heap.push(Cursor(top.first, top.second + 1));
+	}
+	return sorted;
+}
+
+// Decodes rowids [lo, hi] on its own read only connection and sorts the
+// partition by name, stable so equal names stay in table order
+static void loadPartition(const std::string& dbFile, sqlite3_int64 lo, sqlite3_int64 hi,
+	bool packed, std::vector<Character>& out) {
+	sqlite3* db;
+	sqlite3_stmt* stmt;
+
+	int rc = sqlite3_open_v2(dbFile.c_str(), &db, SQLITE_OPEN_READONLY | SQLITE_OPEN_NOMUTEX, nullptr);
+	if (rc != SQLITE_OK) {
+		std::string err = sqlite3_errmsg(db);
+		sqlite3_close(db);
+		throw std::runtime_error("Cannot Open Database: " + err);
+	}
+
+	const char* sql = packed
+		? "SELECT " PACKED_CHARACTER_COLUMNS " FROM Characters WHERE rowid BETWEEN ?1 AND ?2 ORDER BY rowid;"
+		: "SELECT " CHARACTER_COLUMNS " FROM Characters WHERE rowid BETWEEN ?1 AND ?2 ORDER BY rowid;";
+	rc = sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr);
+	if (rc != SQLITE_OK) {
+		std::string err = sqlite3_errmsg(db);
+		sqlite3_close(db);
+		throw std::runtime_error("Failed to prepare statement: " + err);
+	}
+	sqlite3_bind_int64(stmt, 1, lo);
+	sqlite3_bind_int64(stmt, 2, hi);
+
+	while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+		try {
+			out.push_back(readCharacterRow(stmt, 0, packed));
+		}
+		catch (...) {
+			sqlite3_finalize(stmt);
+			sqlite3_close(db);
+			throw;
+		}
+	}
+
+	if (rc != SQLITE_DONE) {
+		std::string err = sqlite3_errmsg(db);
+		sqlite3_finalize(stmt);
+		sqlite3_close(db);
+		throw std::runtime_error("Error Reading Database: " + err);
+	}
+	sqlite3_finalize(stmt);
+	sqlite3_close(db);
+
+	std::stable_sort(out.begin(), out.end(), [](const Character& a, const Character& b) { return a.name < b.name; });
+}
+
+// Decodes the table with one worker per rowid range then merges the partitions
+std::vector<Character> CharacterDatabase::readSortedParallel(const std::string& dbFile, unsigned int workers) {
+	sqlite3* db;
+	sqlite3_stmt* stmt;
+
+	//Open Database and find the rowid range
+	int rc = sqlite3_open(dbFile.c_str(), &db);
+	if (rc != SQLITE_OK) {
+		std::string err = sqlite3_errmsg(db);
+		sqlite3_close(db);
+		throw std::runtime_error("Cannot Open Database: " + err);
+	}
+
+	rc = sqlite3_exec(db, createTableSQL, nullptr, nullptr, nullptr);
+	if (rc != SQLITE_OK) {
+		std::string err = sqlite3_errmsg(db);
+		sqlite3_close(db);
+		throw std::runtime_error("Failed to create table: " + err);
+	}
+
+	rc = sqlite3_prepare_v2(db, "SELECT MIN(rowid), MAX(rowid), COUNT(*) FROM Characters;", -1, &stmt, nullptr);
+	if (rc != SQLITE_OK || sqlite3_step(stmt) != SQLITE_ROW) {
+		std::string err = sqlite3_errmsg(db);
+		sqlite3_finalize(stmt);
+		sqlite3_close(db);
+		throw std::runtime_error("Failed to read table range: " + err);
+	}
+	sqlite3_int64 minRow = sqlite3_column_int64(stmt, 0);
+	sqlite3_int64 maxRow = sqlite3_column_int64(stmt, 1);
+	sqlite3_int64 count = sqlite3_column_int64(stmt, 2);
+	sqlite3_finalize(stmt);
+	bool packed = schemaVersion(db) >= packedStatsVersion;
+	sqlite3_close(db);
+
+	// Empty table
+	if (count == 0) return std::vector<Character>();
+
+	// Small tables are not worth a thread each
+	const sqlite3_int64 minRowsPerWorker = 4096;
+	if (workers == 0) workers = std::max(1u, std::thread::hardware_concurrency());
+	sqlite3_int64 useful = std::max<sqlite3_int64>(1, count / minRowsPerWorker);
+	if (useful < workers) workers = static_cast<unsigned int>(useful);
+
+	// Split rowids into even ranges, one per worker
+	std::vector<std::vector<Character>> partitions(workers);
+	std::vector<std::exception_ptr> errors(workers);
+	std::vector<std::thread> threads;
+	sqlite3_int64 span = (maxRow - minRow) / workers + 1;
+	for (unsigned int i = 0; i < workers; ++i) {
+		sqlite3_int64 lo = minRow + span * i;
+		sqlite3_int64 hi = (i + 1 == workers) ? maxRow : lo + span - 1;
+		threads.emplace_back([&, i, lo, hi]() {
+			try {
+				loadPartition(dbFile, lo, hi, packed, partitions[i]);
+			}
+			catch (...) {
+				errors[i] = std::current_exception();
+			}
+			});
+	}
+	for (auto& t : threads) t.join();
+	for (auto& e : errors) {
+		if (e) std::rethrow_exception(e);
+	}
+
+	// Merge the sorted partitions, skipping duplicate names
+	return mergeSortedRuns(partitions, [](const Character& c) { warnDuplicate(c.name); });
+}
+
+void CharacterDatabase::loadFromDBParallel(const std::string& dbFile, unsigned int workers) {
+	std::vector<Character> sorted = readSortedParallel(dbFile, workers);
+	if (sorted.empty()) return;
+
+	// Fresh database gets a balanced tree, otherwise merge into the existing one.
+	// Lock free writers may add records mid build, so that index always merges.
+	WriteGuard guard = lockForWrite();
+	if (!lockFree && index->empty()) {
+		writable().buildFromSorted(sorted);
+	}
+	else {
+		for (auto& c : sorted) {
+			if (writable().tryInsert(std::move(c)) == CrudStatus::Duplicate) warnDuplicate(c.name);
+		}
+	}
+	republish();
+}
+
+//======================================
+//	Pipelined Loading
+//======================================
+
+// Loads characters with SQLite reads overlapped with tree inserts.
+// The reader thread owns the connection, an empty batch marks the end.
+void CharacterDatabase::loadFromDBPipelined(const std::string& dbFile, size_t batchSize) {
+	if (batchSize == 0) batchSize = 1;
+	SpscQueue<std::vector<Character>> queue(8);
+	std::exception_ptr readError;
+
+	std::thread reader([&]() {
+		sqlite3* db = nullptr;
+		sqlite3_stmt* stmt = nullptr;
+		try {
+			//Open Database
+			int rc = sqlite3_open(dbFile.c_str(), &db);
+			if (rc != SQLITE_OK) {
+				throw std::runtime_error("Cannot Open Database: " + std::string(sqlite3_errmsg(db)));
+			}
+
+			// If table does not exist create it
+			rc = sqlite3_exec(db, createTableSQL, nullptr, nullptr, nullptr);
+			if (rc != SQLITE_OK) throw std::runtime_error("Failed to create table: " + std::string(sqlite3_errmsg(db)));
+
+			bool packed = schemaVersion(db) >= packedStatsVersion;
+			const char* sql = packed
+				? "SELECT " PACKED_CHARACTER_COLUMNS " FROM Characters;"
+				: "SELECT " CHARACTER_COLUMNS " FROM Characters;";
+			rc = sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr);
+			if (rc != SQLITE_OK) throw std::runtime_error("Failed to prepare statement: " + std::string(sqlite3_errmsg(db)));
+
+			// Decode rows into batches and hand them to the consumer
+			std::vector<Character> batch;
+			batch.reserve(batchSize);
+			while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+				batch.push_back(readCharacterRow(stmt, 0, packed));
+				if (batch.size() == batchSize) {
+					queue.push(batch);
+					batch = std::vector<Character>();
+					batch.reserve(batchSize);
+				}
+			}
+			if (rc != SQLITE_DONE) throw std::runtime_error("Error Reading Database: " + std::string(sqlite3_errmsg(db)));
+			if (!batch.empty()) queue.push(batch);
+		}
+		catch (...) {
+			readError = std::current_exception();
+		}
+		sqlite3_finalize(stmt);
+		sqlite3_close(db);
+
+		// End of stream
+		std::vector<Character> done;
+		queue.push(done);
+		});
+
+	// Consume batches into the BST until the end marker. If the consumer
+	// fails it keeps draining so the reader can finish before the join.
+	std::vector<Character> batch;
+	bool ended = false;
+	try {
+		WriteGuard guard = lockForWrite();
+		while (true) {
+			queue.pop(batch);
+			if (batch.empty()) break;
+			for (auto& c : batch) {
+				if (writable().tryInsert(std::move(c)) == CrudStatus::Duplicate) warnDuplicate(c.name);
+			}
+		}
+		ended = true;
+		republish();
+	}
+	catch (...) {
+		while (!ended) {
+			queue.pop(batch);
+			ended = batch.empty();
+		}
+		reader.join();
+		throw;
+	}
+	reader.join();
+
+	if (readError) std::rethrow_exception(readError);
+}
+
 //===================================
 // Crud Wrapper Functions for DB
 //===================================
-void CharacterDatabase::addCharacter(const Character& c) { bst.insert(c); }
-void CharacterDatabase::displayCharacters() { bst.displayAll(); }
-Character* CharacterDatabase::findCharacter(const std::string& name) { return bst.search(name); }
-void CharacterDatabase::updateCharacter(const std::string& name, const Character& c) { bst.update(name, c); }
-void CharacterDatabase::deleteCharacter(const std::string& name) { bst.remove(name); }
\ No newline at end of file
+static std::unique_ptr<CharacterIndex> makeIndex(IndexBackend backend) {
+	switch (backend) {
+	case IndexBackend::SkipList:
+		return std::unique_ptr<CharacterIndex>(new CharacterSkipList());
+	case IndexBackend::Split:
+		return std::unique_ptr<CharacterIndex>(new CharacterSplitBST());
+	case IndexBackend::BPlusTree:
+		return std::unique_ptr<CharacterIndex>(new CharacterBPlusTree());
+	case IndexBackend::RadixTree:
+		return std::unique_ptr<CharacterIndex>(new CharacterRadixTree());
+	case IndexBackend::CompactTree:
+		return std::unique_ptr<CharacterIndex>(new CompactCharacterBST());
+	case IndexBackend::Tree:
+	default:
+		return std::unique_ptr<CharacterIndex>(new CharacterBST());
+	}
+}
+
+CharacterDatabase::CharacterDatabase(bool threadSafe, IndexBackend backend)
+	: index(makeIndex(backend)), backend(backend), threadSafe(threadSafe), lockFree(threadSafe && index->isConcurrent()) {}
+CharacterDatabase::~CharacterDatabase() = default;
+
+//===================================
+// Locking
+//===================================
+
+// Writers from threads other than the transaction owner pass
+// the gate first, so they wait for an open transaction
+CharacterDatabase::WriteGuard CharacterDatabase::lockForWrite() {
+	WriteGuard guard;
+	if (!threadSafe || lockFree) return guard;
+	if (transactionOwner.load() != std::this_thread::get_id()) {
+		guard.gate = std::unique_lock<std::mutex>(writerGate);
+	}
+	guard.lock = std::unique_lock<std::shared_mutex>(rw);
+	return guard;
+}
+
+std::shared_lock<std::shared_mutex> CharacterDatabase::lockForRead() const {
+	if (!threadSafe || lockFree) return std::shared_lock<std::shared_mutex>();
+	return std::shared_lock<std::shared_mutex>(rw);
+}
+
+void CharacterDatabase::addCharacter(const Character& c) {
+	if (tryAddCharacter(c) != CrudStatus::Ok) throw insertError(c.name);
+}
+void CharacterDatabase::displayCharacters() {
+	auto lock = lockForRead();
+	index->displayAll();
+}
+// The split backend assembles records on read, so it has none to point
+// at until frozen, when the frozen index holds whole records
+Character* CharacterDatabase::findCharacter(const std::string& name) {
+	auto lock = lockForRead();
+	if (!frozen && backend == IndexBackend::Split) {
+		throw std::runtime_error("Find failed: not supported by the split backend, use getCharacter.");
+	}
+	return searchIndex(name);
+}
+void CharacterDatabase::updateCharacter(const std::string& name, const Character& c) {
+	CrudStatus status = tryUpdateCharacter(name, c);
+	if (status == CrudStatus::Invalid) throw renameError(name);
+	if (status != CrudStatus::Ok) throw updateError(name);
+	std::cout << "updated: " + name;
+}
+void CharacterDatabase::deleteCharacter(const std::string& name) {
+	if (tryDeleteCharacter(name) != CrudStatus::Ok) throw deleteError(name);
+	std::cout << "removed: " + name;
+}
+
+CrudStatus CharacterDatabase::patchCharacter(const std::string& name, const std::function<void(Character&)>& mutator,
+	uint32_t fields, uint32_t* changed) {
+	uint64_t seq = 0;
+	uint32_t dirty = 0;
+	{
+		WriteGuard guard = lockForWrite();
+		Character before, logged;
+		CrudStatus status = applyPatch(name, fields, mutator, dirty,
+			transactionActive ? &before : nullptr, oplog ? &logged : nullptr);
+		if (status != CrudStatus::Ok) return status;
+		if (dirty) {
+			if (transactionActive) undoLog.push_back({ UndoEntry::Updated, name, before });
+			LogRecord record = { LogRecord::Patch, name, logged };
+			record.fields = dirty;
+			seq = logWrite(record);
+		}
+	}
+	waitLogged(seq);
+	if (changed) *changed = dirty;
+	return CrudStatus::Ok;
+}
+
+// Non throwing CRUD, only changes that happened are undo logged and logged
+CrudStatus CharacterDatabase::tryAddCharacter(const Character& c) {
+	uint64_t seq;
+	{
+		WriteGuard guard = lockForWrite();
+		CrudStatus status = applyInsert(c);
+		if (status != CrudStatus::Ok) return status;
+		if (transactionActive) undoLog.push_back({ UndoEntry::Added, c.name, Character() });
+		seq = logWrite({ LogRecord::Add, c.name, c });
+	}
+	waitLogged(seq);
+	return CrudStatus::Ok;
+}
+// Backends key records by name, so a rename is refused like in batches
+CrudStatus CharacterDatabase::tryUpdateCharacter(const std::string& name, const Character& c) {
+	if (c.name != name) return CrudStatus::Invalid;
+	uint64_t seq;
+	{
+		WriteGuard guard = lockForWrite();
+		if (transactionActive) {
+			Character before;
+			if (!index->lookup(name, before)) return CrudStatus::NotFound;
+			CrudStatus status = applyUpdate(name, c);
+			if (status != CrudStatus::Ok) return status;
+			undoLog.push_back({ UndoEntry::Updated, c.name, before });
+		}
+		else {
+			CrudStatus status = applyUpdate(name, c);
+			if (status != CrudStatus::Ok) return status;
+		}
+		seq = logWrite({ LogRecord::Update, name, c });
+	}
+	waitLogged(seq);
+	return CrudStatus::Ok;
+}
+CrudStatus CharacterDatabase::tryDeleteCharacter(const std::string& name) {
+	uint64_t seq;
+	{
+		WriteGuard guard = lockForWrite();
+		if (transactionActive) {
+			Character before;
+			if (!index->lookup(name, before)) return CrudStatus::NotFound;
+			CrudStatus status = applyRemove(name);
+			if (status != CrudStatus::Ok) return status;
+			undoLog.push_back({ UndoEntry::Deleted, name, before });
+		}
+		else {
+			CrudStatus status = applyRemove(name);
+			if (status != CrudStatus::Ok) return status;
+		}
+		seq = logWrite({ LogRecord::Delete, name, Character() });
+	}
+	waitLogged(seq);
+	return CrudStatus::Ok;
+}
+
+//===================================
+// Batch CRUD
+//===================================
+
+// Name an op is sorted and matched on
+static const std::string& opKey(const CharacterOp& op) {
+	return op.kind == CharacterOp::Add ? op.record.name : op.name;
+}
+
+std::vector<CrudStatus> CharacterDatabase::applyBatch(const std::vector<CharacterOp>& ops) {
+	std::vector<CrudStatus> status(ops.size(), CrudStatus::Ok);
+	// Positions sorted by name, stable so ops on one name keep their order
+	std::vector<size_t> order(ops.size());
+	for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+	std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return opKey(ops[a]) < opKey(ops[b]); });
+
+	std::vector<LogRecord> logged;
+	uint64_t seq = 0;
+	{
+		WriteGuard guard = lockForWrite();
+		// A rebuild costs one pass over the tree, worth it once the batch
+		// touches a good share of it. Lock free writers rule it out.
+		if (!lockFree && ops.size() * 4 >= index->size()) {
+			mergeBatch(ops, order, status, logged);
+		}
+		else {
+			for (size_t at : order) status[at] = applyOp(ops[at], logged);
+		}
+		if (oplog && !logged.empty()) {
+			if (transactionActive) pendingLog.insert(pendingLog.end(), logged.begin(), logged.end());
+			else seq = oplog->enqueue(logged);
+		}
+	}
+	waitLogged(seq);
+	return status;
+}
+
+// One op through the point path
+CrudStatus CharacterDatabase::applyOp(const CharacterOp& op, std::vector<LogRecord>& logged) {
+	const std::string& key = opKey(op);
+	if (op.kind == CharacterOp::Add) {
+		CrudStatus status = applyInsert(op.record);
+		if (status != CrudStatus::Ok) return status;
+		if (transactionActive) undoLog.push_back({ UndoEntry::Added, key, Character() });
+		logged.push_back({ LogRecord::Add, key, op.record });
+		return CrudStatus::Ok;
+	}
+
+	Character before;
+	if (transactionActive && !index->lookup(key, before)) return CrudStatus::NotFound;
+	if (op.kind == CharacterOp::Update) {
+		if (op.record.name != key) return index->contains(key) ? CrudStatus::Invalid : CrudStatus::NotFound;
+		CrudStatus status = applyUpdate(key, op.record);
+		if (status != CrudStatus::Ok) return status;
+		if (transactionActive) undoLog.push_back({ UndoEntry::Updated, key, before });
+		logged.push_back({ LogRecord::Update, key, op.record });
+	}
+	else {
+		CrudStatus status = applyRemove(key);
+		if (status != CrudStatus::Ok) return status;
+		if (transactionActive) undoLog.push_back({ UndoEntry::Deleted, key, before });
+		logged.push_back({ LogRecord::Delete, key, Character() });
+	}
+	return CrudStatus::Ok;
+}
+
+// Walks the in order copy and the sorted ops together, then rebuilds
+// the tree balanced from the merged run in one pass
+void CharacterDatabase::mergeBatch(const std::vector<CharacterOp>& ops, const std::vector<size_t>& order,
+	std::vector<CrudStatus>& status, std::vector<LogRecord>& logged) {
+	std::vector<Character> current = collectAll();
+	std::vector<Character> merged;
+	merged.reserve(current.size() + ops.size());
+	size_t next = 0;
+	size_t i = 0;
+	while (i < order.size()) {
+		const std::string& key = opKey(ops[order[i]]);
+		while (next < current.size() && current[next].name < key) merged.push_back(std::move(current[next++]));
+		std::optional<Character> record;
+		if (next < current.size() && current[next].name == key) record = std::move(current[next++]);
+
+		// Every op on this name, in input order
+		for (; i < order.size() && opKey(ops[order[i]]) == key; ++i) {
+			size_t at = order[i];
+			const CharacterOp& op = ops[at];
+			if (op.kind == CharacterOp::Add) {
+				if (record) {
+					status[at] = CrudStatus::Duplicate;
+					continue;
+				}
+				record = op.record;
+				if (transactionActive) undoLog.push_back({ UndoEntry::Added, key, Character() });
+				logged.push_back({ LogRecord::Add, key, op.record });
+			}
+			else if (!record) {
+				status[at] = CrudStatus::NotFound;
+			}
+			else if (op.kind == CharacterOp::Update) {
+				if (op.record.name != key) {
+					status[at] = CrudStatus::Invalid;
+					continue;
+				}
+				if (transactionActive) undoLog.push_back({ UndoEntry::Updated, key, *record });
+				record = op.record;
+				logged.push_back({ LogRecord::Update, key, op.record });
+			}
+			else {
+				if (transactionActive) undoLog.push_back({ UndoEntry::Deleted, key, *record });
+				record.reset();
+				logged.push_back({ LogRecord::Delete, key, Character() });
+			}
+		}
+		if (record) merged.push_back(std::move(*record));
+	}
+	while (next < current.size()) merged.push_back(std::move(current[next++]));
+
+	writable().clear();
+	writable().buildFromSorted(merged);
+	republish();
+}
+
+// Copy out under the read lock
+std::optional<Character> CharacterDatabase::getCharacter(const std::string& name) const {
+	auto lock = lockForRead();
+	if (hotCache) {
+		const Character* record = searchIndex(name);
+		if (!record) return std::nullopt;
+		return *record;
+	}
+	if (nameFilter && !nameFilter->mayContain(name)) return std::nullopt;
+	Character c;
+	if (!index->lookup(name, c)) return std::nullopt;
+	return c;
+}
+
+// Callers hold the read lock. Readers may admit concurrently, the
+// cache locks its own stripes.
+Character* CharacterDatabase::searchIndex(const std::string& name) const {
+	Character* record = hotCache ? hotCache->find(name) : nullptr;
+	if (record) return record;
+	if (nameFilter && !nameFilter->mayContain(name)) return nullptr;
+	record = index->search(name);
+	if (record && hotCache) hotCache->admit(name, record);
+	return record;
+}
+
+std::vector<Character> CharacterDatabase::getAllCharacters() const {
+	auto lock = lockForRead();
+	return collectAll();
+}
+
+std::vector<Character> CharacterDatabase::getCharactersWithPrefix(const std::string& prefix) const {
+	auto lock = lockForRead();
+	std::vector<Character> found;
+	index->forEachWithPrefix(prefix, [&](const Character& c) { found.push_back(c); });
+	return found;
+}
+
+std::vector<Character> CharacterDatabase::collectAll() const {
+	std::vector<Character> all;
+	index->forEachInOrder([&](const Character& c) { all.push_back(c); });
+	return all;
+}
+
+//===================================
+// Stat Handles
+//===================================
+// Runs the index change inside the record's seqlock write, so its
+// stats are published in the same order the index applied them.
+// Nothing is published when the change reports a failure.
+template <typename Change>
+static CrudStatus withStats(const std::shared_ptr<StatBlock>& block, const Character* after, Change change) {
+	if (!block) return change();
+	StatBlock::Writer writer(*block);
+	CrudStatus status = change();
+	if (status != CrudStatus::Ok) return status;
+	if (after) {
+		CharacterStats stats = statsOf(*after);
+		writer.set(&stats);
+	}
+	else {
+		writer.set(nullptr);
+	}
+	return status;
+}
+
+std::shared_ptr<StatBlock> CharacterDatabase::statBlockFor(const std::string& name) const {
+	if (!hasStatHandles.load()) return nullptr;
+	std::shared_ptr<const StatRegistry> registry = std::atomic_load(&statRegistry);
+	auto it = registry->find(name);
+	return it == registry->end() ? nullptr : it->second;
+}
+
+StatHandle CharacterDatabase::statHandle(const std::string& name) {
+	std::lock_guard<std::mutex> lock(statRegistryLock);
+	std::shared_ptr<const StatRegistry> registry = std::atomic_load(&statRegistry);
+	if (registry) {
+		auto it = registry->find(name);
+		if (it != registry->end()) return StatHandle(it->second);
+	}
+
+	std::shared_ptr<StatBlock> block = std::make_shared<StatBlock>();
+	std::shared_ptr<StatRegistry> next = registry ? std::make_shared<StatRegistry>(*registry) : std::make_shared<StatRegistry>();
+	(*next)[name] = block;
+
+	// Published under the write lock so no write lands between the
+	// first fill and writers finding the block
+	WriteGuard guard = lockForWrite();
+	std::atomic_store(&statRegistry, std::shared_ptr<const StatRegistry>(next));
+	hasStatHandles.store(true);
+	Character current;
+	bool found = index->lookup(name, current);
+	withStats(block, found ? &current : nullptr, []() { return CrudStatus::Ok; });
+	return StatHandle(block);
+}
+
+// Loads and replay write the index directly, catch every block up
+void CharacterDatabase::refreshStats() {
+	if (!hasStatHandles.load()) return;
+	std::shared_ptr<const StatRegistry> registry = std::atomic_load(&statRegistry);
+	for (const auto& entry : *registry) {
+		Character current;
+		bool found = index->lookup(entry.first, current);
+		withStats(entry.second, found ? &current : nullptr, []() { return CrudStatus::Ok; });
+	}
+}
+
+//===================================
+// Change Application
+// Index first, then the published version, failures change nothing
+//===================================
+CrudStatus CharacterDatabase::applyInsert(const Character& c) {
+	CrudStatus status = withStats(statBlockFor(c.name), &c, [&]() { return writable().tryInsert(c); });
+	if (status != CrudStatus::Ok) return status;
+	if (nameFilter) {
+		nameFilter->add(c.name);
+		if (nameFilter->needsRebuild()) rebuildNameFilter();
+	}
+	CharacterSnapshot current = std::atomic_load(&published);
+	if (current) std::atomic_store(&published, CharacterSnapshot(new PersistentCharacterBST(current->inserted(c))));
+	return CrudStatus::Ok;
+}
+
+CrudStatus CharacterDatabase::applyUpdate(const std::string& name, const Character& c) {
+	CrudStatus status = withStats(statBlockFor(name), &c, [&]() { return writable().tryUpdate(name, c); });
+	if (status != CrudStatus::Ok) return status;
+	if (hotCache) hotCache->forget(name);
+	CharacterSnapshot current = std::atomic_load(&published);
+	if (current) std::atomic_store(&published, CharacterSnapshot(new PersistentCharacterBST(current->updated(name, c))));
+	return CrudStatus::Ok;
+}
+
+CrudStatus CharacterDatabase::applyRemove(const std::string& name) {
+	CrudStatus status = withStats(statBlockFor(name), nullptr, [&]() { return writable().tryRemove(name); });
+	if (status != CrudStatus::Ok) return status;
+	if (nameFilter) {
+		nameFilter->noteRemoval();
+		if (nameFilter->needsRebuild()) rebuildNameFilter();
+	}
+	if (hotCache) hotCache->forget(name);
+	CharacterSnapshot current = std::atomic_load(&published);
+	if (current) std::atomic_store(&published, CharacterSnapshot(new PersistentCharacterBST(current->removed(name))));
+	return CrudStatus::Ok;
+}
+
+// Runs mutator on the stored record. Only the fields listed in fields
+// are compared, so strings are copied only for patches that touch
+// them. before gets the full old record and logged the changed
+// fields when asked for.
+CrudStatus CharacterDatabase::applyPatch(const std::string& name, uint32_t fields, const std::function<void(Character&)>& mutator,
+	uint32_t& changed, Character* before, Character* logged) {
+	CharacterStats stats;
+	Character after;
+	CharacterSnapshot current = std::atomic_load(&published);
+	auto patch = [&](Character& c) {
+		Character old = Character();
+		copyFields(old, c, fields);
+		if (before) *before = c;
+		mutator(c);
+		c.name = name;
+		changed = changedFields(old, c, fields);
+		if (changed & CharacterField::Stats) stats = statsOf(c);
+		if (changed && current) after = c;
+		if (changed && logged) copyFields(*logged, c, changed);
+		};
+
+	changed = 0;
+	CrudStatus status;
+	std::shared_ptr<StatBlock> block = (fields & CharacterField::Stats) ? statBlockFor(name) : nullptr;
+	if (block) {
+		StatBlock::Writer writer(*block);
+		status = writable().tryPatch(name, patch);
+		if (changed & CharacterField::Stats) writer.set(&stats);
+	}
+	else {
+		status = writable().tryPatch(name, patch);
+	}
+	// Some backends patch a copy and swap it in
+	if (hotCache && status == CrudStatus::Ok) hotCache->forget(name);
+	if (status != CrudStatus::Ok || !changed) return status;
+	if (current) std::atomic_store(&published, CharacterSnapshot(new PersistentCharacterBST(current->updated(name, after))));
+	return CrudStatus::Ok;
+}
+
+// Bulk changes bypass the per change path copies, rebuild once instead
+void CharacterDatabase::republish() {
+	refreshStats();
+	if (nameFilter) rebuildNameFilter();
+	if (hotCache) hotCache->clear();
+	if (!std::atomic_load(&published)) return;
+	std::vector<Character> all = collectAll();
+	std::atomic_store(&published, CharacterSnapshot(new PersistentCharacterBST(PersistentCharacterBST::fromSorted(all))));
+}
+
+//===================================
+// Name Filter
+//===================================
+void CharacterDatabase::enableNameFilter() {
+	if (lockFree) {
+		throw std::runtime_error("Name filter failed: not supported by the lock free backend.");
+	}
+	WriteGuard guard = lockForWrite();
+	rebuildNameFilter();
+}
+
+void CharacterDatabase::disableNameFilter() {
+	WriteGuard guard = lockForWrite();
+	nameFilter.reset();
+}
+
+// Sized with headroom for twice the current roster
+void CharacterDatabase::rebuildNameFilter() {
+	std::unique_ptr<NameFilter> fresh(new NameFilter(index->size() * 2));
+	index->forEachInOrder([&](const Character& c) { fresh->add(c.name); });
+	nameFilter = std::move(fresh);
+}
+
+//===================================
+// Hot Cache
+// Entries point into the index, so anything that
+// rebuilds or swaps the index clears them
+//===================================
+void CharacterDatabase::enableHotCache(size_t capacity) {
+	if (lockFree) {
+		throw std::runtime_error("Hot cache failed: not supported by the lock free backend.");
+	}
+	if (backend == IndexBackend::Split) {
+		throw std::runtime_error("Hot cache failed: the split backend keeps no whole records.");
+	}
+	if (backend == IndexBackend::CompactTree) {
+		throw std::runtime_error("Hot cache failed: the compact tree moves records as it grows.");
+	}
+	WriteGuard guard = lockForWrite();
+	hotCache.reset(new HotCharacterCache(capacity));
+}
+
+void CharacterDatabase::disableHotCache() {
+	WriteGuard guard = lockForWrite();
+	hotCache.reset();
+}
+
+HotCacheStats CharacterDatabase::hotCacheStats() const {
+	auto lock = lockForRead();
+	return hotCache ? hotCache->stats() : HotCacheStats();
+}
+
+//===================================
+// Freezing
+//===================================
+void CharacterDatabase::freeze() {
+	if (lockFree) {
+		throw std::runtime_error("Freeze failed: not supported by the lock free backend.");
+	}
+	WriteGuard guard = lockForWrite();
+	if (frozen) return;
+	std::vector<Character> all = collectAll();
+	index.reset(new FrozenCharacterIndex(std::move(all)));
+	frozen = true;
+	if (hotCache) hotCache->clear();
+}
+
+// Callers hold the write lock
+CharacterIndex& CharacterDatabase::writable() {
+	if (frozen) {
+		std::vector<Character> all = static_cast<FrozenCharacterIndex&>(*index).release();
+		std::unique_ptr<CharacterIndex> thawed = makeIndex(backend);
+		thawed->buildFromSorted(all);
+		index = std::move(thawed);
+		frozen = false;
+		if (hotCache) hotCache->clear();
+	}
+	return *index;
+}
+
+//===================================
+// Snapshots
+//===================================
+void CharacterDatabase::enableSnapshots() {
+	if (lockFree) {
+		throw std::runtime_error("Snapshots failed: not supported by the lock free backend.");
+	}
+	WriteGuard guard = lockForWrite();
+	if (std::atomic_load(&published)) return;
+	std::vector<Character> all = collectAll();
+	std::atomic_store(&published, CharacterSnapshot(new PersistentCharacterBST(PersistentCharacterBST::fromSorted(all))));
+}
+
+void CharacterDatabase::disableSnapshots() {
+	WriteGuard guard = lockForWrite();
+	std::atomic_store(&published, CharacterSnapshot());
+}
+
+// Readers holding older versions keep their nodes alive until released
+CharacterSnapshot CharacterDatabase::snapshot() const {
+	CharacterSnapshot current = std::atomic_load(&published);
+	if (current) return current;
+	auto lock = lockForRead();
+	return CharacterSnapshot(new PersistentCharacterBST(PersistentCharacterBST::fromSorted(collectAll())));
+}
+
+//===================================
+// Transactions
+//===================================
+void CharacterDatabase::begin() {
+	if (lockFree) {
+		throw std::runtime_error("Begin failed: transactions are not supported by the lock free backend.");
+	}
+	if (transactionOwner.load() == std::this_thread::get_id()) {
+		throw std::runtime_error("Begin failed: a transaction is already active.");
+	}
+	// Wait for other writers and transactions, keep the gate until the end
+	std::unique_lock<std::mutex> gate;
+	if (threadSafe) gate = std::unique_lock<std::mutex>(writerGate);
+	std::unique_lock<std::shared_mutex> lock;
+	if (threadSafe) lock = std::unique_lock<std::shared_mutex>(rw);
+
+	if (transactionActive) {
+		throw std::runtime_error("Begin failed: a transaction is already active.");
+	}
+	transactionActive = true;
+	undoLog.clear();
+	pendingLog.clear();
+	if (threadSafe) {
+		transactionGate = std::move(gate);
+		transactionOwner.store(std::this_thread::get_id());
+	}
+}
+
+// Changes are already applied, commit drops the undo log and
+// makes the whole transaction durable as one log frame
+void CharacterDatabase::commit() {
+	if (threadSafe && transactionOwner.load() != std::this_thread::get_id()) {
+		throw std::runtime_error("Commit failed: no active transaction on this thread.");
+	}
+	uint64_t seq = 0;
+	{
+		WriteGuard guard = lockForWrite();
+		if (!transactionActive) {
+			throw std::runtime_error("Commit failed: no active transaction.");
+		}
+		transactionActive = false;
+		undoLog.clear();
+		if (oplog && !pendingLog.empty()) {
+			std::vector<LogRecord> records;
+			records.swap(pendingLog);
+			seq = oplog->enqueue(records);
+		}
+		if (threadSafe) {
+			transactionOwner.store(std::thread::id());
+			transactionGate = std::unique_lock<std::mutex>();
+		}
+	}
+	waitLogged(seq);
+}
+
+// Applies the before images newest first
+void CharacterDatabase::rollback() {
+	if (threadSafe && transactionOwner.load() != std::this_thread::get_id()) {
+		throw std::runtime_error("Rollback failed: no active transaction on this thread.");
+	}
+	WriteGuard guard = lockForWrite();
+	if (!transactionActive) {
+		throw std::runtime_error("Rollback failed: no active transaction.");
+	}
+	transactionActive = false;
+	for (auto it = undoLog.rbegin(); it != undoLog.rend(); ++it) {
+		switch (it->op) {
+		case UndoEntry::Added:
+			applyRemove(it->name);
+			break;
+		case UndoEntry::Updated:
+			applyUpdate(it->name, it->before);
+			break;
+		case UndoEntry::Deleted:
+			applyInsert(it->before);
+			break;
+		}
+	}
+	undoLog.clear();
+	pendingLog.clear();
+	if (threadSafe) {
+		transactionOwner.store(std::thread::id());
+		transactionGate = std::unique_lock<std::mutex>();
+	}
+}
+
+//===================================
+// Write Ahead Log
+//===================================
+
+// Called under the write lock after the in memory change succeeded,
+// so log order matches memory order. Returns 0 when nothing to wait on.
+uint64_t CharacterDatabase::logWrite(const LogRecord& record) {
+	if (!oplog) return 0;
+	if (transactionActive) {
+		pendingLog.push_back(record);
+		return 0;
+	}
+	return oplog->enqueue(std::vector<LogRecord>(1, record));
+}
+
+// Returns once the frame is durable, may run a checkpoint
+void CharacterDatabase::waitLogged(uint64_t seq) {
+	if (seq == 0) return;
+	oplog->waitDurable(seq);
+	if (checkpointEvery > 0 && oplog->recordCount() >= checkpointEvery) {
+		WriteGuard guard = lockForWrite();
+		// Another writer may have checkpointed while we waited
+		if (!transactionActive && oplog->recordCount() >= checkpointEvery) checkpointLocked();
+	}
+}
+
+// Replayed records carry full images so applying them twice is harmless
+void CharacterDatabase::applyLogRecord(const LogRecord& record) {
+	if (record.op == LogRecord::Delete) {
+		applyRemove(record.name);
+	}
+	else if (record.op == LogRecord::Patch) {
+		uint32_t changed;
+		applyPatch(record.name, record.fields,
+			[&](Character& c) { copyFields(c, record.record, record.fields); }, changed, nullptr, nullptr);
+	}
+	else if (applyUpdate(record.name, record.record) == CrudStatus::NotFound) {
+		applyInsert(record.record);
+	}
+}
+
+void CharacterDatabase::openLog(const std::string& logFile, const std::string& snapshotFile, size_t checkpointEvery) {
+	if (lockFree) {
+		throw std::runtime_error("Open log failed: not supported by the lock free backend.");
+	}
+	WriteGuard guard = lockForWrite();
+	if (oplog) {
+		throw std::runtime_error("Open log failed: a log is already open.");
+	}
+
+	// Last checkpoint replaces whatever was loaded, it is newer,
+	// even when it is empty because every character was deleted
+	std::vector<Character> snapshot;
+	bool haveSnapshot = OperationLog::readSnapshot(snapshotFile, [&](const LogRecord& r) {
+		snapshot.push_back(r.record);
+		});
+	if (haveSnapshot) {
+		writable().clear();
+		writable().buildFromSorted(snapshot);
+		republish();
+	}
+
+	OperationLog::replay(logFile, [&](const LogRecord& r) { applyLogRecord(r); });
+
+	oplog.reset(new OperationLog(logFile));
+	snapshotPath = snapshotFile;
+	this->checkpointEvery = checkpointEvery;
+}
+
+// Writes the full roster as the new snapshot, then empties the log
+void CharacterDatabase::checkpoint() {
+	WriteGuard guard = lockForWrite();
+	if (!oplog) {
+		throw std::runtime_error("Checkpoint failed: no log is open.");
+	}
+	if (transactionActive) {
+		throw std::runtime_error("Checkpoint failed: a transaction is active.");
+	}
+	checkpointLocked();
+}
+
+void CharacterDatabase::checkpointLocked() {
+	OperationLog::writeSnapshot(snapshotPath, collectAll());
+	oplog->reset();
+}
+
+// Not safe while other threads are still writing
+void CharacterDatabase::closeLog() {
+	WriteGuard guard = lockForWrite();
+	oplog.reset();
+	pendingLog.clear();
+}
@@ -15,12 +15,30 @@
 #ifndef CHARACTER_H
 #define CHARACTER_H
 
+#include "ObjectPool.h"
+#include "StatBlock.h"
+#include "NameFilter.h"
+#include "HotCharacterCache.h"
 #include <iostream>
 #include <string>
 #include <vector>
 #include <iomanip>
 #include <functional>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <optional>
+#include <thread>
+#include <atomic>
+#include <unordered_map>
+#include <cstdint>
 
+class OperationLog;
+struct LogRecord;
+class PersistentCharacterBST;
+
+// Immutable view of the roster at one point in time
+typedef std::shared_ptr<const PersistentCharacterBST> CharacterSnapshot;
 
 //==========================================
 // Character Data Structure
@@ -48,33 +66,157 @@ struct Character {
 
 };
 
+//==================================
+// Character Fields
+// One bit per field for partial updates,
+// the name is the key and never patched
+//==================================
+namespace CharacterField {
+    enum : uint32_t {
+        Ability1 = 1u << 0,
+        Ability2 = 1u << 1,
+        Ability3 = 1u << 2,
+        Ability4 = 1u << 3,
+        GunDPS = 1u << 4,
+        BulletDMG = 1u << 5,
+        Ammo = 1u << 6,
+        BulletSpeed = 1u << 7,
+        LightMeleeDMG = 1u << 8,
+        HeavyMeleeDMG = 1u << 9,
+        Health = 1u << 10,
+        Regen = 1u << 11,
+        BulletResist = 1u << 12,
+        SpiritResist = 1u << 13,
+        Speed = 1u << 14,
+        Sprint = 1u << 15,
+        Stamina = 1u << 16,
+
+        Abilities = 0xFu,
+        Stats = 0x1FFF0u,
+        All = 0x1FFFFu
+    };
+}
+
+// Fields among the given ones that differ between two records
+uint32_t changedFields(const Character& a, const Character& b, uint32_t fields = CharacterField::All);
+// Copies the given fields, strings are only copied when asked for
+void copyFields(Character& to, const Character& from, uint32_t fields);
+// Numeric part of a record, and writing it back
+CharacterStats statsOf(const Character& c);
+void setStats(Character& c, const CharacterStats& stats);
+// First 8 bytes of a name, big endian and zero padded, so
+// integer order matches name order
+uint64_t namePrefix(const std::string& name);
+
 
 //==================================
 // Node Structure
 //==================================
 struct Node {
-    Character data;
+    uint64_t prefix;        //namePrefix(data.name), kept next to the links
     Node* left;
     Node* right;
+    Character data;
+
+    //Constructors to initialize node with character, copied or moved in
+    explicit Node(const Character& c);
+    explicit Node(Character&& c);
+
+    // Orders name, whose namePrefix is key, against this node. Differing
+    // prefixes decide without reading the name bytes on the heap.
+    int compare(const std::string& name, uint64_t key) const {
+        if (key != prefix) return key < prefix ? -1 : 1;
+        return name.compare(data.name);
+    }
+};
+
+// Outcome of one change, returned by the try functions
+enum class CrudStatus {
+    Ok,
+    Duplicate,      // Add of a name that exists
+    NotFound,       // Update or Delete of a missing name
+    Invalid         // Update that renames, use Delete then Add
+};
+
+//==================================
+// Character Index Interface
+// Ordered map from name to record,
+// the storage behind CharacterDatabase
+//==================================
+class CharacterIndex {
+public:
+    virtual ~CharacterIndex() {}
+
+    // Report duplicates and misses as a status, one descent each and
+    // no message strings, for loaders and other hot paths
+    virtual CrudStatus tryInsert(const Character& c) = 0;
+    // Moves the record in, c is left untouched unless Ok
+    virtual CrudStatus tryInsert(Character&& c) = 0;
+    virtual CrudStatus tryUpdate(const std::string& name, const Character& updated) = 0;
+    virtual CrudStatus tryRemove(const std::string& name) = 0;
+    // Runs mutator on the stored record, which must keep its name.
+    // Concurrent indexes may run it more than once on a fresh copy.
+    virtual CrudStatus tryPatch(const std::string& name, const std::function<void(Character&)>& mutator) = 0;
 
-    //Constructor to initialize node with character
-    Node(Character c);
+    // Throwing forms of the above
+    void insert(const Character& c);
+    void insert(Character&& c);
+    void update(const std::string& name, const Character& updated);
+    void remove(const std::string& name);
+
+    // Pointer to the stored record, indexes that store no
+    // whole records throw
+    virtual Character* search(const std::string& name) = 0;
+    virtual const Character* search(const std::string& name) const = 0;
+    virtual void displayAll() = 0;
+    virtual void buildFromSorted(std::vector<Character>& sorted) = 0;
+    virtual bool empty() const = 0;
+    virtual size_t size() const = 0;
+    virtual void clear() = 0;
+
+    // Copies the record out, false if not found
+    virtual bool lookup(const std::string& name, Character& out) const = 0;
+    // Runs fn on the record while it is safe to read
+    virtual bool visit(const std::string& name, const std::function<void(const Character&)>& fn) const = 0;
+    virtual void forEachInOrder(const std::function<void(const Character&)>& fn) const = 0;
+    // Records whose name starts with prefix, in order. The default
+    // filters a full walk, indexes that can seek override it.
+    virtual void forEachWithPrefix(const std::string& prefix, const std::function<void(const Character&)>& fn) const;
+    // Membership without handing out a record pointer
+    virtual bool contains(const std::string& name) const { return search(name) != nullptr; }
+
+    // True when the index synchronizes its own readers and writers
+    virtual bool isConcurrent() const { return false; }
+};
 
+// Index implementations a CharacterDatabase can be built on
+enum class IndexBackend {
+    Tree,       // CharacterBST
+    SkipList,   // CharacterSkipList, lock free
+    Split,      // CharacterSplitBST, key only nodes, stats and text stored apart
+    BPlusTree,  // CharacterBPlusTree, wide nodes and linked leaves
+    RadixTree,  // CharacterRadixTree, adaptive radix tree with prefix scans
+    CompactTree // CompactCharacterBST, nodes in one vector with 32 bit links
 };
 
 //==================================
 // Character BST Class
+// Records never move between nodes,
+// so search pointers stay valid until
+// that record itself is removed
 //==================================
-class CharacterBST {
+class CharacterBST : public CharacterIndex {
 private:
     Node* root;
+    size_t count;
+    ObjectPool<Node> pool;                              //Node storage owned by this tree
 
-    Node* insert(Node* node, const Character& c);       //Insert Character into Subtree
-    Node* search(Node* node, const std::string& name);  //Search subtree for character
+    Node* search(Node* node, const std::string& name) const;  //Search subtree for character
+    Node** insertLink(const std::string& name);         //Empty link where name belongs, null if taken
     void inorder(Node* node);                           //In order Traversal
-    Node* findMin(Node* node);                          //find smallest node
-    Node* remove(Node* node, const std::string& name);  //Delete node from subtree
+    void inorder(const Node* node, const std::function<void(const Character&)>& fn) const;
     void destroy(Node* node); 
+    Node* buildBalanced(std::vector<Character>& sorted, size_t lo, size_t hi); //Build subtree from sorted range
 
 public:
     // Initializes empty tree
@@ -82,47 +224,269 @@ public:
     ~CharacterBST();
 
     //Interface functions
-    void insert(const Character& c);
-    Character* search(const std::string& name);
-    void displayAll();
-    void update(const std::string& name, const Character& updated);
-    void remove(const std::string& name);
+    CrudStatus tryInsert(const Character& c) override;
+    CrudStatus tryInsert(Character&& c) override;
+    CrudStatus tryUpdate(const std::string& name, const Character& updated) override;
+    CrudStatus tryRemove(const std::string& name) override;
+    CrudStatus tryPatch(const std::string& name, const std::function<void(Character&)>& mutator) override;
+    Character* search(const std::string& name) override;
+    const Character* search(const std::string& name) const override;
+    void displayAll() override;
+
+    // Replaces an empty tree with a balanced tree built from
+    // records already sorted by name with no duplicates
+    void buildFromSorted(std::vector<Character>& sorted) override;
+    bool empty() const override { return root == nullptr; }
+    size_t size() const override { return count; }
+    void clear() override;
+
+    bool lookup(const std::string& name, Character& out) const override;
+    bool visit(const std::string& name, const std::function<void(const Character&)>& fn) const override;
+    void forEachInOrder(const std::function<void(const Character&)>& fn) const override;
 
     Node* getRoot() { return root; }
+    const Node* getRoot() const { return root; }
+};
+
+//==================================
+// Undo Log Entry
+// Before image of one change made
+// inside a transaction
+//==================================
+struct UndoEntry {
+    enum Op { Added, Updated, Deleted };
+
+    Op op;
+    std::string name;       // Key of the record after the change
+    Character before;       // Previous record, unused for Added
 };
 
+//==================================
+// Character Operation
+// One change in a batch, keyed by name
+//==================================
+struct CharacterOp {
+    enum Kind { Add, Update, Delete };
+
+    Kind kind;
+    std::string name;       // Key, the record's name for Add
+    Character record;       // New record, unused for Delete
+
+    static CharacterOp add(const Character& c) { return { Add, c.name, c }; }
+    static CharacterOp update(const std::string& name, const Character& c) { return { Update, name, c }; }
+    static CharacterOp remove(const std::string& name) { return { Delete, name, Character() }; }
+};
+
+// K-way merge of runs each sorted by name, moving the records out.
+// Equal names are taken from the lowest numbered run first; only
+// that record is kept and the others go to onDuplicate.
+std::vector<Character> mergeSortedRuns(std::vector<std::vector<Character>>& runs,
+    const std::function<void(const Character&)>& onDuplicate = nullptr);
+
 //==================================
 // Character Database Class
 //==================================
 class CharacterDatabase {
 
 private:
-    //BST to store the characters
-    CharacterBST bst;
+    //Index that stores the characters, a BST unless chosen otherwise.
+    //freeze swaps in a read only index, writable swaps the backend back.
+    std::unique_ptr<CharacterIndex> index;
+    const IndexBackend backend;
+    bool frozen = false;
+    CharacterIndex& writable();
+
+    //Thread safe mode: readers share rw, writers own it. writerGate
+    //is held by an open transaction so other threads' writes wait.
+    //A concurrent index skips both, lockFree is set then.
+    const bool threadSafe;
+    const bool lockFree;
+    mutable std::shared_mutex rw;
+    std::mutex writerGate;
+    std::unique_lock<std::mutex> transactionGate;
+    std::atomic<std::thread::id> transactionOwner;
+
+    //Locks held by one write, empty when not thread safe
+    struct WriteGuard {
+        std::unique_lock<std::mutex> gate;
+        std::unique_lock<std::shared_mutex> lock;
+    };
+    WriteGuard lockForWrite();
+    std::shared_lock<std::shared_mutex> lockForRead() const;
+
+    //Open transaction state, undo log replayed backwards on rollback
+    bool transactionActive = false;
+    std::vector<UndoEntry> undoLog;
+
+    //Write ahead log, records of an open transaction wait in pendingLog
+    std::unique_ptr<OperationLog> oplog;
+    std::string snapshotPath;
+    size_t checkpointEvery = 0;
+    std::vector<LogRecord> pendingLog;
+
+    //Latest immutable version for snapshots, null when disabled.
+    //Replaced with std::atomic_store so readers never take rw.
+    CharacterSnapshot published;
+
+    //Seqlocked stats of records someone holds a StatHandle for. The map
+    //is copy on write so writers find their block without a lock.
+    typedef std::unordered_map<std::string, std::shared_ptr<StatBlock>> StatRegistry;
+    std::shared_ptr<const StatRegistry> statRegistry;
+    std::atomic<bool> hasStatHandles{ false };
+    std::mutex statRegistryLock;                        //Serializes handle creation
+    std::shared_ptr<StatBlock> statBlockFor(const std::string& name) const;
+    void refreshStats();
+
+    //Optional filter that turns away most lookups of absent names
+    std::unique_ptr<NameFilter> nameFilter;
+    void rebuildNameFilter();
+
+    //Optional cache of the most requested records
+    std::unique_ptr<HotCharacterCache> hotCache;
+    Character* searchIndex(const std::string& name) const;
+
+    //Every CRUD change goes through these so the published version follows
+    CrudStatus applyInsert(const Character& c);
+    CrudStatus applyUpdate(const std::string& name, const Character& c);
+    CrudStatus applyRemove(const std::string& name);
+    CrudStatus applyPatch(const std::string& name, uint32_t fields, const std::function<void(Character&)>& mutator,
+        uint32_t& changed, Character* before, Character* logged);
+    void republish();                               //Rebuild versions and stats after loads and replay
+
+    uint64_t logWrite(const LogRecord& record);     //Log or buffer one change, returns frame to wait on
+    void waitLogged(uint64_t seq);                  //Wait for durability outside the locks
+    void applyLogRecord(const LogRecord& record);   //Replay one change as an upsert/delete
+    void checkpointLocked();
+    CrudStatus applyOp(const CharacterOp& op, std::vector<LogRecord>& logged);
+    void mergeBatch(const std::vector<CharacterOp>& ops, const std::vector<size_t>& order,
+        std::vector<CrudStatus>& status, std::vector<LogRecord>& logged);
+    std::vector<Character> collectAll() const;      //In order copy, caller holds a lock
 
         
 public:
+    // Thread safe mode allows any number of concurrent readers
+    // alongside writers. Pointers from findCharacter are only safe
+    // while no other thread writes, use getCharacter there instead.
+    // With the SkipList backend thread safe CRUD never takes a
+    // database lock, but transactions, the log and snapshots need
+    // writers in one order and are refused.
+    explicit CharacterDatabase(bool threadSafe = false, IndexBackend backend = IndexBackend::Tree);
+    ~CharacterDatabase();
 
     //Character functions
     void loadFromDB(const std::string& dbFile);
+    // Splits the table into rowid ranges and decodes them on
+    // separate read connections, 0 workers = one per core
+    void loadFromDBParallel(const std::string& dbFile, unsigned int workers = 0);
+    // The same decode without a database, rows sorted by name with
+    // duplicates dropped, for callers that build their own indexes
+    static std::vector<Character> readSortedParallel(const std::string& dbFile, unsigned int workers = 0);
+    // Steps and decodes rows on a reader thread while the calling
+    // thread inserts the finished batches into the tree
+    void loadFromDBPipelined(const std::string& dbFile, size_t batchSize = 256);
+    // Upgrades a database to schema version 2, which adds a packed
+    // Stats BLOB next to the classic per stat columns. Rows written
+    // through the classic columns afterwards still load correctly.
+    static void upgradeToPackedStats(const std::string& dbFile);
     void addCharacter(const Character& c);
     void displayCharacters();
+    // Pointer to the stored record, throws on the split backend
+    // unless the database is frozen
     Character* findCharacter(const std::string& name);
     void updateCharacter(const std::string& name, const Character& c);
     void deleteCharacter(const std::string& name);
 
-    // Return all characters in sorted order
-    std::vector<Character> getAllCharacters() {
-        std::vector<Character> all;
-        std::function<void(Node*)> traverse = [&](Node* node) {
-            if (!node) return;
-            traverse(node->left);
-            all.push_back(node->data);
-            traverse(node->right);
-            };
-        traverse(bst.getRoot());
-        return all;
+    // Edits the stored record in place, no copy out and no second
+    // lookup. fields names what mutator may touch (it must not rename),
+    // changed receives the fields that really changed. Only those reach
+    // stat handles, snapshots and the log, nothing at all if none did.
+    CrudStatus patchCharacter(const std::string& name, const std::function<void(Character&)>& mutator,
+        uint32_t fields = CharacterField::All, uint32_t* changed = nullptr);
+
+    // Same changes reporting Duplicate, NotFound or Invalid (a
+    // rename) instead of throwing
+    CrudStatus tryAddCharacter(const Character& c);
+    CrudStatus tryUpdateCharacter(const std::string& name, const Character& c);
+    CrudStatus tryDeleteCharacter(const std::string& name);
+
+    // Applies ops sorted by name, keeping their order per name, and
+    // returns each op's status in input order instead of throwing.
+    // Large batches merge with an in order copy of the tree and
+    // rebuild it balanced in one pass. Logged as one frame.
+    std::vector<CrudStatus> applyBatch(const std::vector<CharacterOp>& ops);
+
+    // Lookups that stay valid after the lock is released
+    std::optional<Character> getCharacter(const std::string& name) const;
+
+    // Runs fn on the record under the read lock, false if not found
+    template <typename Fn>
+    bool withCharacter(const std::string& name, Fn fn) const {
+        auto lock = lockForRead();
+        return index->visit(name, fn);
     }
+
+    bool isThreadSafe() const { return threadSafe; }
+    bool isLockFree() const { return lockFree; }
+
+    // Moves the roster into a read only sorted array, with a minimal
+    // perfect hash over the names for O(1) lookups and an Eytzinger
+    // layout for prefix scans. The first write after it rebuilds the
+    // backend from that array in O(n). Not supported by the lock free
+    // backend.
+    void freeze();
+    bool isFrozen() const { return frozen; }
+
+    // Bloom filter checked by findCharacter and getCharacter before
+    // the index, so most misses skip the descent. Kept up by every
+    // change and rebuilt after loads or enough deletes. Not supported
+    // by the lock free backend.
+    void enableNameFilter();
+    void disableNameFilter();
+
+    // Serves the most requested names from a small striped cache in
+    // front of findCharacter and getCharacter. A name is only cached
+    // once it is asked for more often than the entry it replaces.
+    // Not supported by the lock free, split or compact tree backends.
+    void enableHotCache(size_t capacity = 1024);
+    void disableHotCache();
+    HotCacheStats hotCacheStats() const;
+
+    // Transactions over the CRUD functions, rollback undoes every
+    // change since begin in O(changes). Loads are not logged.
+    // In thread safe mode writes from other threads wait for commit
+    // or rollback, readers may see uncommitted changes.
+    void begin();
+    void commit();
+    // Ends the transaction even if an undo step fails, then throws
+    void rollback();
+    bool inTransaction() const { return transactionActive; }
+
+    // Durability: restores the last snapshot (if any) and replays the
+    // log on top of the current contents, then logs every CRUD change.
+    // A checkpoint is taken after checkpointEvery logged records, 0 = never.
+    void openLog(const std::string& logFile, const std::string& snapshotFile, size_t checkpointEvery = 10000);
+    void checkpoint();
+    void closeLog();
+
+    // Snapshots: once enabled every write publishes a new version
+    // by path copying, and snapshot() is an O(1) consistent view that
+    // never blocks writers. Without it snapshot() copies the roster.
+    // Changes made through findCharacter pointers are not published.
+    void enableSnapshots();
+    void disableSnapshots();
+    CharacterSnapshot snapshot() const;
+
+    // Lock free reads of one record's numeric stats. Every change made
+    // through this database is published to the handle, readers retry
+    // instead of seeing a half written record. The handle outlives the
+    // record and reports it as missing. With the lock free backend a
+    // handle created during a write to its record may miss that write.
+    StatHandle statHandle(const std::string& name);
+
+    // Return all characters in sorted order
+    std::vector<Character> getAllCharacters() const;
+    // Characters whose name starts with prefix, in sorted order
+    std::vector<Character> getCharactersWithPrefix(const std::string& prefix) const;
 };
 
-#endif
\ No newline at end of file
+#endif
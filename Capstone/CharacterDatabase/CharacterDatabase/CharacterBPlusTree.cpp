@@ -0,0 +1,480 @@
+// ===========================================================
+// Capstone Project
+// CRUD Functionality - BST - SQLite - Html Report
+// Author: Austin Thompson
+// ------------------------------------------------------
+// Description: Cache conscious B+ tree keyed by character name.
+//-------------------------------------------------------
+// ===========================================================
+
+#include "CharacterBPlusTree.h"
+#include <stdexcept>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+static const uint64_t noKey = UINT64_MAX;
+
+//======================================
+//		Nodes
+//======================================
+CharacterBPlusTree::BNode::BNode(bool leaf) : count(0), leaf(leaf) {
+	for (int i = 0; i < capacity; ++i) prefix[i] = noKey;
+}
+
+CharacterBPlusTree::Leaf::Leaf() : BNode(true), next(nullptr) {
+	for (int i = 0; i < capacity; ++i) records[i] = nullptr;
+}
+
+void CharacterBPlusTree::Leaf::insertAt(int pos, Character* record) {
+	for (int i = count; i > pos; --i) {
+		prefix[i] = prefix[i - 1];
+		records[i] = records[i - 1];
+	}
+	prefix[pos] = namePrefix(record->name);
+	records[pos] = record;
+	++count;
+}
+
+void CharacterBPlusTree::Leaf::eraseAt(int pos) {
+	for (int i = pos; i + 1 < count; ++i) {
+		prefix[i] = prefix[i + 1];
+		records[i] = records[i + 1];
+	}
+	--count;
+	prefix[count] = noKey;
+	records[count] = nullptr;
+}
+
+CharacterBPlusTree::Inner::Inner() : BNode(false) {
+	for (int i = 0; i <= capacity; ++i) children[i] = nullptr;
+}
+
+void CharacterBPlusTree::Inner::insertAt(int pos, const std::string& key, BNode* right) {
+	for (int i = count; i > pos; --i) {
+		prefix[i] = prefix[i - 1];
+		keys[i] = std::move(keys[i - 1]);
+		children[i + 1] = children[i];
+	}
+	setKey(pos, key);
+	children[pos + 1] = right;
+	++count;
+}
+
+void CharacterBPlusTree::Inner::eraseAt(int pos) {
+	for (int i = pos; i + 1 < count; ++i) {
+		prefix[i] = prefix[i + 1];
+		keys[i] = std::move(keys[i + 1]);
+		children[i + 1] = children[i + 2];
+	}
+	--count;
+	prefix[count] = noKey;
+	keys[count].clear();
+	children[count + 1] = nullptr;
+}
+
+void CharacterBPlusTree::Inner::setKey(int pos, const std::string& key) {
+	keys[pos] = key;
+	prefix[pos] = namePrefix(key);
+}
+
+CharacterBPlusTree::CharacterBPlusTree() : root(nullptr), count(0) {}
+CharacterBPlusTree::~CharacterBPlusTree() { destroy(root); }
+
+//======================================
+//		Key Search
+//======================================
+
+// Prefixes below key, over the whole array so there are no branches.
+// Padding is UINT64_MAX and never counts.
+int CharacterBPlusTree::countLess(const uint64_t* prefix, uint64_t key) {
+#if defined(__AVX2__)
+	// AVX2 compares signed lanes, flipping the top bit makes it unsigned
+	const __m256i flip = _mm256_set1_epi64x(INT64_MIN);
+	const __m256i target = _mm256_xor_si256(_mm256_set1_epi64x(static_cast<long long>(key)), flip);
+	__m256i total = _mm256_setzero_si256();
+	for (int i = 0; i < capacity; i += 4) {
+		__m256i lanes = _mm256_xor_si256(_mm256_load_si256(reinterpret_cast<const __m256i*>(prefix + i)), flip);
+		total = _mm256_sub_epi64(total, _mm256_cmpgt_epi64(target, lanes));
+	}
+	alignas(32) uint64_t sums[4];
+	_mm256_store_si256(reinterpret_cast<__m256i*>(sums), total);
+	return static_cast<int>(sums[0] + sums[1] + sums[2] + sums[3]);
+#else
+	int less = 0;
+	for (int i = 0; i < capacity; ++i) less += prefix[i] < key;
+	return less;
+#endif
+}
+
+// Number of separators at or below name
+int CharacterBPlusTree::childIndex(const Inner* node, const std::string& name, uint64_t key) {
+	int i = countLess(node->prefix, key);
+	while (i < node->count && node->prefix[i] == key && node->keys[i] <= name) ++i;
+	return i;
+}
+
+// First record not below name
+int CharacterBPlusTree::leafPos(const Leaf* leaf, const std::string& name, uint64_t key) {
+	int i = countLess(leaf->prefix, key);
+	while (i < leaf->count && leaf->prefix[i] == key && leaf->records[i]->name < name) ++i;
+	return i;
+}
+
+CharacterBPlusTree::Leaf* CharacterBPlusTree::descend(const std::string& name, uint64_t key, PathEntry* path, int& depth) const {
+	depth = 0;
+	BNode* node = root;
+	while (!node->leaf) {
+		Inner* inner = static_cast<Inner*>(node);
+		int i = childIndex(inner, name, key);
+		if (path) path[depth] = { inner, i };
+		++depth;
+		node = inner->children[i];
+	}
+	return static_cast<Leaf*>(node);
+}
+
+Character* CharacterBPlusTree::find(const std::string& name) const {
+	if (!root) return nullptr;
+	uint64_t key = namePrefix(name);
+	int depth;
+	Leaf* leaf = descend(name, key, nullptr, depth);
+	int i = leafPos(leaf, name, key);
+	if (i < leaf->count && leaf->prefix[i] == key && leaf->records[i]->name == name) return leaf->records[i];
+	return nullptr;
+}
+
+//======================================
+//		Insert
+//======================================
+
+// Copies c, or moves from movable (which is c) once the name is known free
+CrudStatus CharacterBPlusTree::insertRecord(const Character& c, Character* movable) {
+	if (!root) root = leaves.create();
+	uint64_t key = namePrefix(c.name);
+	PathEntry path[maxDepth];
+	int depth;
+	Leaf* leaf = descend(c.name, key, path, depth);
+	int pos = leafPos(leaf, c.name, key);
+	if (pos < leaf->count && leaf->prefix[pos] == key && leaf->records[pos]->name == c.name) return CrudStatus::Duplicate;
+
+	Character* record = movable ? records.create(std::move(*movable)) : records.create(c);
+	leaf->insertAt(pos, record);
+	++count;
+	if (leaf->count > maxKeys) splitUp(leaf, path, depth);
+	return CrudStatus::Ok;
+}
+
+// Splits an overfull leaf and carries separators up while parents overflow
+void CharacterBPlusTree::splitUp(Leaf* leaf, PathEntry* path, int depth) {
+	Leaf* right = leaves.create();
+	int half = leaf->count / 2;
+	for (int i = half; i < leaf->count; ++i) {
+		right->prefix[i - half] = leaf->prefix[i];
+		right->records[i - half] = leaf->records[i];
+		leaf->prefix[i] = noKey;
+		leaf->records[i] = nullptr;
+	}
+	right->count = leaf->count - half;
+	leaf->count = half;
+	right->next = leaf->next;
+	leaf->next = right;
+
+	std::string separator = right->records[0]->name;
+	BNode* newChild = right;
+	while (depth > 0) {
+		PathEntry& entry = path[--depth];
+		Inner* node = entry.node;
+		node->insertAt(entry.index, separator, newChild);
+		if (node->count <= maxKeys) return;
+
+		// The middle key moves up, the keys after it go right
+		Inner* sibling = inners.create();
+		int mid = node->count / 2;
+		separator = std::move(node->keys[mid]);
+		for (int i = mid + 1; i < node->count; ++i) {
+			sibling->prefix[i - mid - 1] = node->prefix[i];
+			sibling->keys[i - mid - 1] = std::move(node->keys[i]);
+			sibling->children[i - mid - 1] = node->children[i];
+		}
+		sibling->children[node->count - mid - 1] = node->children[node->count];
+		sibling->count = node->count - mid - 1;
+		for (int i = mid; i < node->count; ++i) {
+			node->prefix[i] = noKey;
+			node->keys[i].clear();
+			node->children[i + 1] = nullptr;
+		}
+		node->count = mid;
+		newChild = sibling;
+	}
+
+	// Root split, the tree grows one level
+	Inner* top = inners.create();
+	top->children[0] = root;
+	top->insertAt(0, separator, newChild);
+	root = top;
+}
+
+CrudStatus CharacterBPlusTree::tryInsert(const Character& c) {
+	return insertRecord(c, nullptr);
+}
+
+CrudStatus CharacterBPlusTree::tryInsert(Character&& c) {
+	return insertRecord(c, &c);
+}
+
+//======================================
+//		Remove
+//======================================
+CrudStatus CharacterBPlusTree::tryRemove(const std::string& name) {
+	if (!root) return CrudStatus::NotFound;
+	uint64_t key = namePrefix(name);
+	PathEntry path[maxDepth];
+	int depth;
+	Leaf* leaf = descend(name, key, path, depth);
+	int pos = leafPos(leaf, name, key);
+	if (pos >= leaf->count || leaf->prefix[pos] != key || leaf->records[pos]->name != name) return CrudStatus::NotFound;
+
+	records.destroy(leaf->records[pos]);
+	leaf->eraseAt(pos);
+	--count;
+
+	// Stale separators still route correctly, only underflow is fixed
+	BNode* node = leaf;
+	while (depth > 0 && node->count < minKeys) {
+		PathEntry& entry = path[--depth];
+		rebalance(entry.node, entry.index);
+		node = entry.node;
+	}
+
+	if (!root->leaf && root->count == 0) {
+		Inner* old = static_cast<Inner*>(root);
+		root = old->children[0];
+		inners.destroy(old);
+	}
+	else if (root->leaf && root->count == 0) {
+		leaves.destroy(static_cast<Leaf*>(root));
+		root = nullptr;
+	}
+	return CrudStatus::Ok;
+}
+
+// Borrows from a sibling with spare keys, otherwise merges into the left one
+void CharacterBPlusTree::rebalance(Inner* parent, int index) {
+	BNode* child = parent->children[index];
+	BNode* left = index > 0 ? parent->children[index - 1] : nullptr;
+	BNode* right = index < parent->count ? parent->children[index + 1] : nullptr;
+
+	if (child->leaf) {
+		Leaf* c = static_cast<Leaf*>(child);
+		Leaf* l = static_cast<Leaf*>(left);
+		Leaf* r = static_cast<Leaf*>(right);
+		if (l && l->count > minKeys) {
+			c->insertAt(0, l->records[l->count - 1]);
+			l->eraseAt(l->count - 1);
+			parent->setKey(index - 1, c->records[0]->name);
+		}
+		else if (r && r->count > minKeys) {
+			c->insertAt(c->count, r->records[0]);
+			r->eraseAt(0);
+			parent->setKey(index, r->records[0]->name);
+		}
+		else {
+			if (!l) {
+				l = c;
+				c = r;
+				++index;
+			}
+			for (int i = 0; i < c->count; ++i) l->insertAt(l->count, c->records[i]);
+			l->next = c->next;
+			leaves.destroy(c);
+			parent->eraseAt(index - 1);
+		}
+		return;
+	}
+
+	Inner* c = static_cast<Inner*>(child);
+	Inner* l = static_cast<Inner*>(left);
+	Inner* r = static_cast<Inner*>(right);
+	if (l && l->count > minKeys) {
+		// Parent separator comes down, left's last key goes up
+		for (int i = c->count; i > 0; --i) {
+			c->prefix[i] = c->prefix[i - 1];
+			c->keys[i] = std::move(c->keys[i - 1]);
+		}
+		for (int i = c->count + 1; i > 0; --i) c->children[i] = c->children[i - 1];
+		c->setKey(0, parent->keys[index - 1]);
+		c->children[0] = l->children[l->count];
+		++c->count;
+		parent->setKey(index - 1, l->keys[l->count - 1]);
+		l->children[l->count] = nullptr;
+		--l->count;
+		l->prefix[l->count] = noKey;
+		l->keys[l->count].clear();
+	}
+	else if (r && r->count > minKeys) {
+		c->setKey(c->count, parent->keys[index]);
+		c->children[c->count + 1] = r->children[0];
+		++c->count;
+		parent->setKey(index, r->keys[0]);
+		r->children[0] = r->children[1];
+		r->eraseAt(0);
+	}
+	else {
+		if (!l) {
+			l = c;
+			c = r;
+			++index;
+		}
+		// Left + separator + right fits in one node
+		l->setKey(l->count, parent->keys[index - 1]);
+		l->children[l->count + 1] = c->children[0];
+		++l->count;
+		for (int i = 0; i < c->count; ++i) {
+			l->prefix[l->count] = c->prefix[i];
+			l->keys[l->count] = std::move(c->keys[i]);
+			l->children[l->count + 1] = c->children[i + 1];
+			++l->count;
+		}
+		inners.destroy(c);
+		parent->eraseAt(index - 1);
+	}
+}
+
+//======================================
+//		Update
+//======================================
+
+// The stored name is the key and stays as is
+CrudStatus CharacterBPlusTree::tryUpdate(const std::string& name, const Character& updated) {
+	Character* record = find(name);
+	if (!record) return CrudStatus::NotFound;
+	std::string key = std::move(record->name);
+	*record = updated;
+	record->name = std::move(key);
+	return CrudStatus::Ok;
+}
+
+CrudStatus CharacterBPlusTree::tryPatch(const std::string& name, const std::function<void(Character&)>& mutator) {
+	Character* record = find(name);
+	if (!record) return CrudStatus::NotFound;
+	mutator(*record);
+	return CrudStatus::Ok;
+}
+
+//======================================
+//		Reads
+//======================================
+Character* CharacterBPlusTree::search(const std::string& name) {
+	return find(name);
+}
+
+const Character* CharacterBPlusTree::search(const std::string& name) const {
+	return find(name);
+}
+
+bool CharacterBPlusTree::lookup(const std::string& name, Character& out) const {
+	const Character* record = find(name);
+	if (!record) return false;
+	out = *record;
+	return true;
+}
+
+bool CharacterBPlusTree::visit(const std::string& name, const std::function<void(const Character&)>& fn) const {
+	const Character* record = find(name);
+	if (!record) return false;
+	fn(*record);
+	return true;
+}
+
+const CharacterBPlusTree::Leaf* CharacterBPlusTree::firstLeaf() const {
+	if (!root) return nullptr;
+	const BNode* node = root;
+	while (!node->leaf) node = static_cast<const Inner*>(node)->children[0];
+	return static_cast<const Leaf*>(node);
+}
+
+// Leaf chain scan, no tree walk
+void CharacterBPlusTree::forEachInOrder(const std::function<void(const Character&)>& fn) const {
+	for (const Leaf* leaf = firstLeaf(); leaf; leaf = leaf->next) {
+		for (int i = 0; i < leaf->count; ++i) fn(*leaf->records[i]);
+	}
+}
+
+void CharacterBPlusTree::displayAll() {
+	if (empty()) {
+		std::cout << "Database is empty." << std::endl;
+		return;
+	}
+	forEachInOrder([](const Character& c) {
+		std::cout << "Character: " << c.name
+			<< " | Gun DPS: " << c.gunDPS
+			<< " | Health: " << c.health << std::endl;
+		});
+}
+
+//======================================
+//		Bulk
+//======================================
+void CharacterBPlusTree::destroy(BNode* node) {
+	if (!node) return;
+	if (node->leaf) {
+		Leaf* leaf = static_cast<Leaf*>(node);
+		for (int i = 0; i < leaf->count; ++i) records.destroy(leaf->records[i]);
+		leaves.destroy(leaf);
+		return;
+	}
+	Inner* inner = static_cast<Inner*>(node);
+	for (int i = 0; i <= inner->count; ++i) destroy(inner->children[i]);
+	inners.destroy(inner);
+}
+
+void CharacterBPlusTree::clear() {
+	destroy(root);
+	root = nullptr;
+	count = 0;
+}
+
+// Packs each level left to right, spreading entries evenly so
+// every node but a lone root starts at least half full
+void CharacterBPlusTree::buildFromSorted(std::vector<Character>& sorted) {
+	if (root) {
+		throw std::runtime_error("Build failed: tree is not empty.");
+	}
+	if (sorted.empty()) return;
+
+	std::vector<BNode*> level;
+	std::vector<std::string> lowest;                    //Least name under each node of level
+	size_t nodes = (sorted.size() + maxKeys - 1) / maxKeys;
+	Leaf* last = nullptr;
+	size_t next = 0;
+	for (size_t n = 0; n < nodes; ++n) {
+		size_t end = sorted.size() * (n + 1) / nodes;
+		Leaf* leaf = leaves.create();
+		for (; next < end; ++next) leaf->insertAt(leaf->count, records.create(std::move(sorted[next])));
+		if (last) last->next = leaf;
+		last = leaf;
+		level.push_back(leaf);
+		lowest.push_back(leaf->records[0]->name);
+	}
+
+	while (level.size() > 1) {
+		std::vector<BNode*> upper;
+		std::vector<std::string> upperLowest;
+		size_t groups = (level.size() + capacity - 1) / capacity;
+		size_t first = 0;
+		for (size_t g = 0; g < groups; ++g) {
+			size_t end = level.size() * (g + 1) / groups;
+			Inner* inner = inners.create();
+			inner->children[0] = level[first];
+			for (size_t i = first + 1; i < end; ++i) inner->insertAt(inner->count, lowest[i], level[i]);
+			upper.push_back(inner);
+			upperLowest.push_back(std::move(lowest[first]));
+			first = end;
+		}
+		level.swap(upper);
+		lowest.swap(upperLowest);
+	}
+	root = level[0];
+	count = sorted.size();
+}
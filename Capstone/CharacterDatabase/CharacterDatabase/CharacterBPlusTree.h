@@ -0,0 +1,118 @@
+// ===========================================================
+// Capstone Project
+// CRUD Functionality - BST - SQLite - Html Report
+// Author: Austin Thompson
+// ------------------------------------------------------
+// Description: B+ tree keyed by character name. Each node
+// keeps the first 8 bytes of its keys as big endian integers
+// in one aligned array, so a level is searched by comparing
+// integers (with AVX2 when the build enables it) and strings
+// are only compared when two prefixes tie. Records live in
+// the leaves' pool and leaves are linked for in order scans.
+//-------------------------------------------------------
+// ===========================================================
+
+#ifndef CHARACTER_BPLUS_TREE_H
+#define CHARACTER_BPLUS_TREE_H
+
+#include "Character.h"
+#include <cstdint>
+
+//==================================
+// Character B+ Tree Class
+// Records are never moved, so search
+// pointers stay valid until that
+// record itself is removed.
+// Nodes hold at most 7 keys so the
+// prefix array searched on every
+// level is one 64 byte cache line;
+// key strings sit on later lines and
+// are only read when prefixes tie.
+//==================================
+class CharacterBPlusTree : public CharacterIndex {
+private:
+    static const int maxKeys = 7;
+    static const int minKeys = maxKeys / 2;
+    static const int capacity = maxKeys + 1;            //One spare slot, full nodes split after an insert
+    static const int maxDepth = 32;
+    static_assert(capacity * sizeof(uint64_t) == 64, "The prefix array must fill one cache line");
+
+    struct BNode {
+        alignas(64) uint64_t prefix[capacity];          //One cache line, unused slots hold UINT64_MAX
+        int count;
+        const bool leaf;
+
+        explicit BNode(bool leaf);
+    };
+
+    struct Leaf : BNode {
+        Character* records[capacity];
+        Leaf* next;
+
+        Leaf();
+        void insertAt(int pos, Character* record);
+        void eraseAt(int pos);
+    };
+
+    struct Inner : BNode {
+        std::string keys[capacity];                     //keys[i] is the least name under children[i + 1]
+        BNode* children[capacity + 1];
+
+        Inner();
+        void insertAt(int pos, const std::string& key, BNode* right);
+        void eraseAt(int pos);                          //Drops keys[pos] and children[pos + 1]
+        void setKey(int pos, const std::string& key);
+    };
+
+    struct PathEntry {
+        Inner* node;
+        int index;
+    };
+
+    BNode* root;
+    size_t count;
+    ObjectPool<Leaf> leaves;
+    ObjectPool<Inner> inners;
+    ObjectPool<Character> records;
+
+    static int countLess(const uint64_t* prefix, uint64_t key);
+    static int childIndex(const Inner* node, const std::string& name, uint64_t key);
+    static int leafPos(const Leaf* leaf, const std::string& name, uint64_t key);
+
+    // Leaf that would hold name, the path down is recorded when asked for
+    Leaf* descend(const std::string& name, uint64_t key, PathEntry* path, int& depth) const;
+    Character* find(const std::string& name) const;
+    CrudStatus insertRecord(const Character& c, Character* movable);
+    void splitUp(Leaf* leaf, PathEntry* path, int depth);
+    void rebalance(Inner* parent, int index);
+    const Leaf* firstLeaf() const;
+    void destroy(BNode* node);
+
+public:
+    CharacterBPlusTree();
+    ~CharacterBPlusTree();
+
+    CharacterBPlusTree(const CharacterBPlusTree&) = delete;
+    CharacterBPlusTree& operator=(const CharacterBPlusTree&) = delete;
+
+    //Interface functions
+    CrudStatus tryInsert(const Character& c) override;
+    CrudStatus tryInsert(Character&& c) override;
+    CrudStatus tryUpdate(const std::string& name, const Character& updated) override;
+    CrudStatus tryRemove(const std::string& name) override;
+    CrudStatus tryPatch(const std::string& name, const std::function<void(Character&)>& mutator) override;
+    Character* search(const std::string& name) override;
+    const Character* search(const std::string& name) const override;
+    void displayAll() override;
+
+    void buildFromSorted(std::vector<Character>& sorted) override;
+    bool empty() const override { return count == 0; }
+    size_t size() const override { return count; }
+    void clear() override;
+
+    bool lookup(const std::string& name, Character& out) const override;
+    bool visit(const std::string& name, const std::function<void(const Character&)>& fn) const override;
+    void forEachInOrder(const std::function<void(const Character&)>& fn) const override;
+};
+
+#endif
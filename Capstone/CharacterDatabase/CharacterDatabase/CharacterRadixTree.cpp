@@ -0,0 +1,559 @@
+// ===========================================================
+// Capstone Project
+// CRUD Functionality - BST - SQLite - Html Report
+// Author: Austin Thompson
+// ------------------------------------------------------
+// Description: Adaptive radix tree keyed by character name.
+//-------------------------------------------------------
+// ===========================================================
+
+#include "CharacterRadixTree.h"
+#include <cstring>
+#include <stdexcept>
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define RADIX_SSE2 1
+#endif
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+static int lowestBit(unsigned mask) {
+#if defined(_MSC_VER)
+	unsigned long index;
+	_BitScanForward(&index, mask);
+	return static_cast<int>(index);
+#else
+	return __builtin_ctz(mask);
+#endif
+}
+
+// Slot of byte among the first count sorted keys, -1 if absent
+static int findKey(const unsigned char* keys, int count, unsigned char byte) {
+	for (int i = 0; i < count; ++i) {
+		if (keys[i] == byte) return i;
+	}
+	return -1;
+}
+
+// Node16 compares all 16 keys at once
+static int findKey16(const unsigned char* keys, int count, unsigned char byte) {
+#if defined(RADIX_SSE2)
+	__m128i matches = _mm_cmpeq_epi8(_mm_set1_epi8(static_cast<char>(byte)),
+		_mm_loadu_si128(reinterpret_cast<const __m128i*>(keys)));
+	unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(matches)) & ((1u << count) - 1);
+	return mask ? lowestBit(mask) : -1;
+#else
+	return findKey(keys, count, byte);
+#endif
+}
+
+//======================================
+//		Nodes
+//======================================
+CharacterRadixTree::Node48::Node48() : ArtNode(N48) {
+	std::memset(slotOf, 0, sizeof(slotOf));
+	for (int i = 0; i < 48; ++i) children[i] = nullptr;
+}
+
+CharacterRadixTree::Node256::Node256() : ArtNode(N256) {
+	for (int i = 0; i < 256; ++i) children[i] = nullptr;
+}
+
+CharacterRadixTree::CharacterRadixTree() : root(nullptr), count(0) {}
+CharacterRadixTree::~CharacterRadixTree() { destroy(root); }
+
+CharacterRadixTree::ArtNode* CharacterRadixTree::newLeaf(const std::string& prefix, Character* record) {
+	Node4* leaf = pool4.create();
+	leaf->prefix = prefix;
+	leaf->value = record;
+	return leaf;
+}
+
+// Frees one node, its children and record are left alone
+void CharacterRadixTree::release(ArtNode* node) {
+	switch (node->type) {
+	case N4: pool4.destroy(static_cast<Node4*>(node)); break;
+	case N16: pool16.destroy(static_cast<Node16*>(node)); break;
+	case N48: pool48.destroy(static_cast<Node48*>(node)); break;
+	case N256: pool256.destroy(static_cast<Node256*>(node)); break;
+	}
+}
+
+CharacterRadixTree::ArtNode** CharacterRadixTree::childRef(ArtNode* node, unsigned char byte) {
+	switch (node->type) {
+	case N4: {
+		Node4* n = static_cast<Node4*>(node);
+		int i = findKey(n->keys, n->count, byte);
+		return i < 0 ? nullptr : &n->children[i];
+	}
+	case N16: {
+		Node16* n = static_cast<Node16*>(node);
+		int i = findKey16(n->keys, n->count, byte);
+		return i < 0 ? nullptr : &n->children[i];
+	}
+	case N48: {
+		Node48* n = static_cast<Node48*>(node);
+		return n->slotOf[byte] ? &n->children[n->slotOf[byte] - 1] : nullptr;
+	}
+	case N256: {
+		Node256* n = static_cast<Node256*>(node);
+		return n->children[byte] ? &n->children[byte] : nullptr;
+	}
+	}
+	return nullptr;
+}
+
+const CharacterRadixTree::ArtNode* CharacterRadixTree::child(const ArtNode* node, unsigned char byte) {
+	ArtNode** ref = childRef(const_cast<ArtNode*>(node), byte);
+	return ref ? *ref : nullptr;
+}
+
+//======================================
+//		Growing and Shrinking
+//======================================
+
+// Adds a child, moving *ref to the next node size when full
+void CharacterRadixTree::addChild(ArtNode** ref, unsigned char byte, ArtNode* newChild) {
+	ArtNode* node = *ref;
+	switch (node->type) {
+	case N4: {
+		Node4* n = static_cast<Node4*>(node);
+		if (n->count < 4) {
+			int i = n->count;
+			for (; i > 0 && n->keys[i - 1] > byte; --i) {
+				n->keys[i] = n->keys[i - 1];
+				n->children[i] = n->children[i - 1];
+			}
+			n->keys[i] = byte;
+			n->children[i] = newChild;
+			++n->count;
+			return;
+		}
+		Node16* grown = pool16.create();
+		grown->prefix = std::move(n->prefix);
+		grown->value = n->value;
+		grown->count = n->count;
+		std::memcpy(grown->keys, n->keys, 4);
+		std::memcpy(grown->children, n->children, 4 * sizeof(ArtNode*));
+		pool4.destroy(n);
+		*ref = grown;
+		addChild(ref, byte, newChild);
+		return;
+	}
+	case N16: {
+		Node16* n = static_cast<Node16*>(node);
+		if (n->count < 16) {
+			int i = n->count;
+			for (; i > 0 && n->keys[i - 1] > byte; --i) {
+				n->keys[i] = n->keys[i - 1];
+				n->children[i] = n->children[i - 1];
+			}
+			n->keys[i] = byte;
+			n->children[i] = newChild;
+			++n->count;
+			return;
+		}
+		Node48* grown = pool48.create();
+		grown->prefix = std::move(n->prefix);
+		grown->value = n->value;
+		grown->count = n->count;
+		for (int i = 0; i < 16; ++i) {
+			grown->children[i] = n->children[i];
+			grown->slotOf[n->keys[i]] = static_cast<unsigned char>(i + 1);
+		}
+		pool16.destroy(n);
+		*ref = grown;
+		addChild(ref, byte, newChild);
+		return;
+	}
+	case N48: {
+		Node48* n = static_cast<Node48*>(node);
+		if (n->count < 48) {
+			int slot = 0;
+			while (n->children[slot]) ++slot;
+			n->children[slot] = newChild;
+			n->slotOf[byte] = static_cast<unsigned char>(slot + 1);
+			++n->count;
+			return;
+		}
+		Node256* grown = pool256.create();
+		grown->prefix = std::move(n->prefix);
+		grown->value = n->value;
+		grown->count = n->count;
+		for (int b = 0; b < 256; ++b) {
+			if (n->slotOf[b]) grown->children[b] = n->children[n->slotOf[b] - 1];
+		}
+		pool48.destroy(n);
+		*ref = grown;
+		addChild(ref, byte, newChild);
+		return;
+	}
+	case N256: {
+		Node256* n = static_cast<Node256*>(node);
+		n->children[byte] = newChild;
+		++n->count;
+		return;
+	}
+	}
+}
+
+// Drops a child, moving *ref to a smaller node once sparse enough
+void CharacterRadixTree::removeChild(ArtNode** ref, unsigned char byte) {
+	ArtNode* node = *ref;
+	switch (node->type) {
+	case N4:
+	case N16: {
+		unsigned char* keys = node->type == N4 ? static_cast<Node4*>(node)->keys : static_cast<Node16*>(node)->keys;
+		ArtNode** children = node->type == N4 ? static_cast<Node4*>(node)->children : static_cast<Node16*>(node)->children;
+		int i = findKey(keys, node->count, byte);
+		for (; i + 1 < node->count; ++i) {
+			keys[i] = keys[i + 1];
+			children[i] = children[i + 1];
+		}
+		--node->count;
+		if (node->type == N16 && node->count <= 3) {
+			Node16* n = static_cast<Node16*>(node);
+			Node4* shrunk = pool4.create();
+			shrunk->prefix = std::move(n->prefix);
+			shrunk->value = n->value;
+			shrunk->count = n->count;
+			std::memcpy(shrunk->keys, n->keys, n->count);
+			std::memcpy(shrunk->children, n->children, n->count * sizeof(ArtNode*));
+			pool16.destroy(n);
+			*ref = shrunk;
+		}
+		return;
+	}
+	case N48: {
+		Node48* n = static_cast<Node48*>(node);
+		n->children[n->slotOf[byte] - 1] = nullptr;
+		n->slotOf[byte] = 0;
+		--n->count;
+		if (n->count <= 12) {
+			Node16* shrunk = pool16.create();
+			shrunk->prefix = std::move(n->prefix);
+			shrunk->value = n->value;
+			for (int b = 0; b < 256; ++b) {
+				if (!n->slotOf[b]) continue;
+				shrunk->keys[shrunk->count] = static_cast<unsigned char>(b);
+				shrunk->children[shrunk->count] = n->children[n->slotOf[b] - 1];
+				++shrunk->count;
+			}
+			pool48.destroy(n);
+			*ref = shrunk;
+		}
+		return;
+	}
+	case N256: {
+		Node256* n = static_cast<Node256*>(node);
+		n->children[byte] = nullptr;
+		--n->count;
+		if (n->count <= 36) {
+			Node48* shrunk = pool48.create();
+			shrunk->prefix = std::move(n->prefix);
+			shrunk->value = n->value;
+			for (int b = 0; b < 256; ++b) {
+				if (!n->children[b]) continue;
+				shrunk->children[shrunk->count] = n->children[b];
+				shrunk->slotOf[b] = static_cast<unsigned char>(shrunk->count + 1);
+				++shrunk->count;
+			}
+			pool256.destroy(n);
+			*ref = shrunk;
+		}
+		return;
+	}
+	}
+}
+
+// A node with no record and one child is folded into that child's prefix
+void CharacterRadixTree::mergeOnlyChild(ArtNode** ref) {
+	Node4* node = static_cast<Node4*>(*ref);
+	ArtNode* only = node->children[0];
+	only->prefix = node->prefix + static_cast<char>(node->keys[0]) + only->prefix;
+	*ref = only;
+	pool4.destroy(node);
+}
+
+//======================================
+//		Search
+//======================================
+
+// One stored prefix compare and one child step per level
+Character* CharacterRadixTree::find(const std::string& name) const {
+	const ArtNode* node = root;
+	size_t depth = 0;
+	while (node) {
+		const std::string& prefix = node->prefix;
+		if (name.compare(depth, prefix.size(), prefix) != 0) return nullptr;
+		depth += prefix.size();
+		if (depth == name.size()) return node->value;
+		node = child(node, static_cast<unsigned char>(name[depth]));
+		++depth;
+	}
+	return nullptr;
+}
+
+Character* CharacterRadixTree::search(const std::string& name) {
+	return find(name);
+}
+
+const Character* CharacterRadixTree::search(const std::string& name) const {
+	return find(name);
+}
+
+bool CharacterRadixTree::lookup(const std::string& name, Character& out) const {
+	const Character* record = find(name);
+	if (!record) return false;
+	out = *record;
+	return true;
+}
+
+bool CharacterRadixTree::visit(const std::string& name, const std::function<void(const Character&)>& fn) const {
+	const Character* record = find(name);
+	if (!record) return false;
+	fn(*record);
+	return true;
+}
+
+//======================================
+//		Insert
+//======================================
+
+// Copies c, or moves from movable (which is c) once the name is known free
+CrudStatus CharacterRadixTree::insertRecord(const Character& c, Character* movable) {
+	const std::string name = c.name;
+	auto make = [&]() { return movable ? records.create(std::move(*movable)) : records.create(c); };
+	ArtNode** ref = &root;
+	size_t depth = 0;
+	while (true) {
+		ArtNode* node = *ref;
+		if (!node) {
+			*ref = newLeaf(name.substr(depth), make());
+			break;
+		}
+
+		// Split the stored prefix where the name leaves it
+		const std::string& prefix = node->prefix;
+		size_t match = 0;
+		while (match < prefix.size() && depth + match < name.size() && prefix[match] == name[depth + match]) ++match;
+		if (match < prefix.size()) {
+			Node4* parent = pool4.create();
+			parent->prefix = prefix.substr(0, match);
+			unsigned char oldByte = static_cast<unsigned char>(prefix[match]);
+			node->prefix = prefix.substr(match + 1);
+			*ref = parent;
+			addChild(ref, oldByte, node);
+			if (depth + match == name.size()) {
+				parent->value = make();
+			}
+			else {
+				addChild(ref, static_cast<unsigned char>(name[depth + match]), newLeaf(name.substr(depth + match + 1), make()));
+			}
+			break;
+		}
+
+		depth += prefix.size();
+		if (depth == name.size()) {
+			if (node->value) return CrudStatus::Duplicate;
+			node->value = make();
+			break;
+		}
+		unsigned char byte = static_cast<unsigned char>(name[depth]);
+		ArtNode** next = childRef(node, byte);
+		if (!next) {
+			addChild(ref, byte, newLeaf(name.substr(depth + 1), make()));
+			break;
+		}
+		ref = next;
+		++depth;
+	}
+	++count;
+	return CrudStatus::Ok;
+}
+
+CrudStatus CharacterRadixTree::tryInsert(const Character& c) {
+	return insertRecord(c, nullptr);
+}
+
+CrudStatus CharacterRadixTree::tryInsert(Character&& c) {
+	return insertRecord(c, &c);
+}
+
+//======================================
+//		Remove
+//======================================
+CrudStatus CharacterRadixTree::tryRemove(const std::string& name) {
+	ArtNode** ref = &root;
+	ArtNode** parentRef = nullptr;
+	unsigned char byte = 0;
+	size_t depth = 0;
+	while (true) {
+		ArtNode* node = *ref;
+		if (!node || name.compare(depth, node->prefix.size(), node->prefix) != 0) return CrudStatus::NotFound;
+		depth += node->prefix.size();
+		if (depth == name.size()) break;
+		ArtNode** next = childRef(node, static_cast<unsigned char>(name[depth]));
+		if (!next) return CrudStatus::NotFound;
+		parentRef = ref;
+		byte = static_cast<unsigned char>(name[depth]);
+		ref = next;
+		++depth;
+	}
+	ArtNode* node = *ref;
+	if (!node->value) return CrudStatus::NotFound;
+	records.destroy(node->value);
+	node->value = nullptr;
+	--count;
+
+	// Keep the tree compressed: no empty nodes, no recordless single child nodes
+	if (node->count == 0) {
+		release(node);
+		if (!parentRef) {
+			root = nullptr;
+			return CrudStatus::Ok;
+		}
+		removeChild(parentRef, byte);
+		ArtNode* parent = *parentRef;
+		if (!parent->value && parent->count == 1) mergeOnlyChild(parentRef);
+	}
+	else if (node->count == 1) {
+		mergeOnlyChild(ref);
+	}
+	return CrudStatus::Ok;
+}
+
+//======================================
+//		Update
+//======================================
+
+// The stored name is the key and stays as is
+CrudStatus CharacterRadixTree::tryUpdate(const std::string& name, const Character& updated) {
+	Character* record = find(name);
+	if (!record) return CrudStatus::NotFound;
+	std::string key = std::move(record->name);
+	*record = updated;
+	record->name = std::move(key);
+	return CrudStatus::Ok;
+}
+
+CrudStatus CharacterRadixTree::tryPatch(const std::string& name, const std::function<void(Character&)>& mutator) {
+	Character* record = find(name);
+	if (!record) return CrudStatus::NotFound;
+	mutator(*record);
+	return CrudStatus::Ok;
+}
+
+//======================================
+//		Ordered Walks
+//======================================
+
+// A node's own record sorts before every name that continues past it
+void CharacterRadixTree::inorder(const ArtNode* node, const std::function<void(const Character&)>& fn) const {
+	if (!node) return;
+	if (node->value) fn(*node->value);
+	switch (node->type) {
+	case N4: {
+		const Node4* n = static_cast<const Node4*>(node);
+		for (int i = 0; i < n->count; ++i) inorder(n->children[i], fn);
+		break;
+	}
+	case N16: {
+		const Node16* n = static_cast<const Node16*>(node);
+		for (int i = 0; i < n->count; ++i) inorder(n->children[i], fn);
+		break;
+	}
+	case N48: {
+		const Node48* n = static_cast<const Node48*>(node);
+		for (int b = 0; b < 256; ++b) {
+			if (n->slotOf[b]) inorder(n->children[n->slotOf[b] - 1], fn);
+		}
+		break;
+	}
+	case N256: {
+		const Node256* n = static_cast<const Node256*>(node);
+		for (int b = 0; b < 256; ++b) inorder(n->children[b], fn);
+		break;
+	}
+	}
+}
+
+void CharacterRadixTree::forEachInOrder(const std::function<void(const Character&)>& fn) const {
+	inorder(root, fn);
+}
+
+// Walks down the prefix, then everything below it is a match
+void CharacterRadixTree::forEachWithPrefix(const std::string& prefix, const std::function<void(const Character&)>& fn) const {
+	const ArtNode* node = root;
+	size_t depth = 0;
+	while (node) {
+		const std::string& stored = node->prefix;
+		size_t rest = prefix.size() - depth;
+		if (rest <= stored.size()) {
+			if (stored.compare(0, rest, prefix, depth, rest) == 0) inorder(node, fn);
+			return;
+		}
+		if (prefix.compare(depth, stored.size(), stored) != 0) return;
+		depth += stored.size();
+		node = child(node, static_cast<unsigned char>(prefix[depth]));
+		++depth;
+	}
+}
+
+void CharacterRadixTree::displayAll() {
+	if (empty()) {
+		std::cout << "Database is empty." << std::endl;
+		return;
+	}
+	forEachInOrder([](const Character& c) {
+		std::cout << "Character: " << c.name
+			<< " | Gun DPS: " << c.gunDPS
+			<< " | Health: " << c.health << std::endl;
+		});
+}
+
+//======================================
+//		Bulk
+//======================================
+void CharacterRadixTree::destroy(ArtNode* node) {
+	if (!node) return;
+	switch (node->type) {
+	case N4: {
+		Node4* n = static_cast<Node4*>(node);
+		for (int i = 0; i < n->count; ++i) destroy(n->children[i]);
+		break;
+	}
+	case N16: {
+		Node16* n = static_cast<Node16*>(node);
+		for (int i = 0; i < n->count; ++i) destroy(n->children[i]);
+		break;
+	}
+	case N48: {
+		Node48* n = static_cast<Node48*>(node);
+		for (int i = 0; i < 48; ++i) destroy(n->children[i]);
+		break;
+	}
+	case N256: {
+		Node256* n = static_cast<Node256*>(node);
+		for (int b = 0; b < 256; ++b) destroy(n->children[b]);
+		break;
+	}
+	}
+	if (node->value) records.destroy(node->value);
+	release(node);
+}
+
+void CharacterRadixTree::clear() {
+	destroy(root);
+	root = nullptr;
+	count = 0;
+}
+
+// Shape depends only on the names, so sorted input is simply inserted
+void CharacterRadixTree::buildFromSorted(std::vector<Character>& sorted) {
+	if (root) {
+		throw std::runtime_error("Build failed: tree is not empty.");
+	}
+	for (Character& c : sorted) insertRecord(c, &c);
+}
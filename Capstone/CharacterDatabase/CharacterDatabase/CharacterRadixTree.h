@@ -0,0 +1,111 @@
+// ===========================================================
+// Capstone Project
+// CRUD Functionality - BST - SQLite - Html Report
+// Author: Austin Thompson
+// ------------------------------------------------------
+// Description: Adaptive radix tree keyed by the bytes of a
+// character name. Each node consumes one byte, runs of single
+// child nodes are folded into a stored prefix, and nodes grow
+// and shrink between 4, 16, 48 and 256 children, so a lookup
+// costs O(name length) whatever the roster size.
+//-------------------------------------------------------
+// ===========================================================
+
+#ifndef CHARACTER_RADIX_TREE_H
+#define CHARACTER_RADIX_TREE_H
+
+#include "Character.h"
+#include <cstdint>
+
+//==================================
+// Character Radix Tree Class
+// Records are never moved, so search
+// pointers stay valid until that
+// record itself is removed
+//==================================
+class CharacterRadixTree : public CharacterIndex {
+private:
+    enum NodeType : uint8_t { N4, N16, N48, N256 };
+
+    struct ArtNode {
+        NodeType type;
+        uint16_t count;                                 //Children in use
+        Character* value;                               //Record whose name ends here
+        std::string prefix;                             //Bytes skipped before the child byte
+
+        explicit ArtNode(NodeType type) : type(type), count(0), value(nullptr) {}
+    };
+
+    struct Node4 : ArtNode {
+        unsigned char keys[4];                          //Sorted
+        ArtNode* children[4];
+        Node4() : ArtNode(N4) {}
+    };
+
+    struct Node16 : ArtNode {
+        unsigned char keys[16];                         //Sorted
+        ArtNode* children[16];
+        Node16() : ArtNode(N16) {}
+    };
+
+    struct Node48 : ArtNode {
+        unsigned char slotOf[256];                      //0 for none, else child slot + 1
+        ArtNode* children[48];
+        Node48();
+    };
+
+    struct Node256 : ArtNode {
+        ArtNode* children[256];
+        Node256();
+    };
+
+    ArtNode* root;
+    size_t count;
+    ObjectPool<Node4> pool4;
+    ObjectPool<Node16> pool16;
+    ObjectPool<Node48> pool48;
+    ObjectPool<Node256> pool256;
+    ObjectPool<Character> records;
+
+    static ArtNode** childRef(ArtNode* node, unsigned char byte);
+    static const ArtNode* child(const ArtNode* node, unsigned char byte);
+    void addChild(ArtNode** ref, unsigned char byte, ArtNode* child);
+    void removeChild(ArtNode** ref, unsigned char byte);
+    void mergeOnlyChild(ArtNode** ref);
+    ArtNode* newLeaf(const std::string& prefix, Character* record);
+    void release(ArtNode* node);
+    void destroy(ArtNode* node);
+
+    Character* find(const std::string& name) const;
+    CrudStatus insertRecord(const Character& c, Character* movable);
+    void inorder(const ArtNode* node, const std::function<void(const Character&)>& fn) const;
+
+public:
+    CharacterRadixTree();
+    ~CharacterRadixTree();
+
+    CharacterRadixTree(const CharacterRadixTree&) = delete;
+    CharacterRadixTree& operator=(const CharacterRadixTree&) = delete;
+
+    //Interface functions
+    CrudStatus tryInsert(const Character& c) override;
+    CrudStatus tryInsert(Character&& c) override;
+    CrudStatus tryUpdate(const std::string& name, const Character& updated) override;
+    CrudStatus tryRemove(const std::string& name) override;
+    CrudStatus tryPatch(const std::string& name, const std::function<void(Character&)>& mutator) override;
+    Character* search(const std::string& name) override;
+    const Character* search(const std::string& name) const override;
+    void displayAll() override;
+
+    void buildFromSorted(std::vector<Character>& sorted) override;
+    bool empty() const override { return count == 0; }
+    size_t size() const override { return count; }
+    void clear() override;
+
+    bool lookup(const std::string& name, Character& out) const override;
+    bool visit(const std::string& name, const std::function<void(const Character&)>& fn) const override;
+    void forEachInOrder(const std::function<void(const Character&)>& fn) const override;
+    void forEachWithPrefix(const std::string& prefix, const std::function<void(const Character&)>& fn) const override;
+};
+
+#endif
@@ -0,0 +1,305 @@
+// ===========================================================
+// Capstone Project
+// CRUD Functionality - BST - SQLite - Html Report
+// Author: Austin Thompson
+// ------------------------------------------------------
+// Description: Lock free skip list keyed by character name.
+//-------------------------------------------------------
+// ===========================================================
+
+#include "CharacterSkipList.h"
+#include "EpochReclaimer.h"
+#include <stdexcept>
+
+//======================================
+//		Nodes
+//======================================
+CharacterSkipList::SkipNode::SkipNode(const std::string& key, Character* record, int height)
+	: key(key), record(record), height(height), owners(2), next(new std::atomic<Link>[height]) {
+	for (int i = 0; i < height; ++i) next[i].store(0);
+}
+
+CharacterSkipList::SkipNode::~SkipNode() {
+	delete record.load();
+	delete[] next;
+}
+
+void CharacterSkipList::deleteNode(void* node) { delete static_cast<SkipNode*>(node); }
+void CharacterSkipList::deleteRecord(void* record) { delete static_cast<Character*>(record); }
+
+// Coin flips, each level holds about half the one below
+int CharacterSkipList::randomHeight() {
+	static thread_local uint64_t state = 0x9E3779B97F4A7C15ull ^ reinterpret_cast<uintptr_t>(&state);
+	state ^= state << 13;
+	state ^= state >> 7;
+	state ^= state << 17;
+	int height = 1;
+	uint64_t bits = state;
+	while (height < maxLevel && (bits & 1)) {
+		++height;
+		bits >>= 1;
+	}
+	return height;
+}
+
+// A node is retired only after its inserter stopped linking it and
+// its remover unlinked it, so no late link can revive a freed node
+void CharacterSkipList::release(SkipNode* node) {
+	if (node->owners.fetch_sub(1) == 1) EpochReclaimer::retire(node, deleteNode);
+}
+
+CharacterSkipList::CharacterSkipList() : head(new SkipNode(std::string(), nullptr, maxLevel)), count(0) {}
+
+CharacterSkipList::~CharacterSkipList() {
+	clear();
+	delete head;
+}
+
+//======================================
+//		Searching
+//======================================
+bool CharacterSkipList::find(const std::string& name, SkipNode** preds, SkipNode** succs) {
+retry:
+	SkipNode* pred = head;
+	for (int level = maxLevel - 1; level >= 0; --level) {
+		SkipNode* curr = target(pred->next[level].load());
+		while (curr) {
+			Link succ = curr->next[level].load();
+			// Unlink marked nodes, start over if pred changed under us
+			if (marked(succ)) {
+				Link expected = linkTo(curr);
+				if (!pred->next[level].compare_exchange_strong(expected, succ & ~Link(1))) goto retry;
+				curr = target(succ);
+				continue;
+			}
+			if (!(curr->key < name)) break;
+			pred = curr;
+			curr = target(succ);
+		}
+		preds[level] = pred;
+		succs[level] = curr;
+	}
+	return succs[0] && succs[0]->key == name;
+}
+
+CharacterSkipList::SkipNode* CharacterSkipList::findNode(const std::string& name) const {
+	SkipNode* pred = head;
+	SkipNode* curr = nullptr;
+	for (int level = maxLevel - 1; level >= 0; --level) {
+		curr = target(pred->next[level].load());
+		while (curr) {
+			Link succ = curr->next[level].load();
+			if (!marked(succ)) {
+				if (!(curr->key < name)) break;
+				pred = curr;
+			}
+			curr = target(succ);
+		}
+	}
+	if (curr && curr->key == name && !marked(curr->next[0].load())) return curr;
+	return nullptr;
+}
+
+//======================================
+//		Insert
+//======================================
+CrudStatus CharacterSkipList::insertRecord(const Character& c, Character* movable) {
+	EpochReclaimer::Guard guard;
+	SkipNode* preds[maxLevel];
+	SkipNode* succs[maxLevel];
+	SkipNode* node = nullptr;
+	const std::string* name = &c.name;
+
+	// Level 0 decides membership
+	while (true) {
+		if (find(*name, preds, succs)) {
+			if (node && movable) *movable = std::move(*node->record.load());
+			delete node;
+			return CrudStatus::Duplicate;
+		}
+		if (!node) {
+			Character* record = movable ? new Character(std::move(*movable)) : new Character(c);
+			node = new SkipNode(record->name, record, randomHeight());
+			name = &node->key;
+		}
+		for (int level = 0; level < node->height; ++level) node->next[level].store(linkTo(succs[level]));
+		Link expected = linkTo(succs[0]);
+		if (preds[0]->next[0].compare_exchange_strong(expected, linkTo(node))) break;
+	}
+	count.fetch_add(1);
+
+	// Upper levels are shortcuts, stop if a remover marked the node
+	for (int level = 1; level < node->height; ++level) {
+		while (true) {
+			Link current = node->next[level].load();
+			if (marked(current)) goto linked;
+			if (target(current) != succs[level] &&
+				!node->next[level].compare_exchange_strong(current, linkTo(succs[level]))) continue;
+			Link expected = linkTo(succs[level]);
+			if (preds[level]->next[level].compare_exchange_strong(expected, linkTo(node))) break;
+			find(*name, preds, succs);
+		}
+	}
+linked:
+	// Removed while linking: links made after its remover's
+	// cleanup pass are undone here
+	if (marked(node->next[0].load())) find(*name, preds, succs);
+	release(node);
+	return CrudStatus::Ok;
+}
+
+CrudStatus CharacterSkipList::tryInsert(const Character& c) {
+	return insertRecord(c, nullptr);
+}
+
+CrudStatus CharacterSkipList::tryInsert(Character&& c) {
+	return insertRecord(c, &c);
+}
+
+//======================================
+//		Remove
+//======================================
+CrudStatus CharacterSkipList::tryRemove(const std::string& name) {
+	EpochReclaimer::Guard guard;
+	SkipNode* preds[maxLevel];
+	SkipNode* succs[maxLevel];
+	if (!find(name, preds, succs)) return CrudStatus::NotFound;
+	SkipNode* node = succs[0];
+
+	// Mark top down, the remover that marks level 0 owns the delete
+	for (int level = node->height - 1; level > 0; --level) {
+		Link link = node->next[level].load();
+		while (!marked(link) && !node->next[level].compare_exchange_weak(link, link | 1)) {}
+	}
+	Link link = node->next[0].load();
+	while (true) {
+		// Lost the race, the other remover owns the delete
+		if (marked(link)) return CrudStatus::NotFound;
+		if (node->next[0].compare_exchange_weak(link, link | 1)) break;
+	}
+	count.fetch_sub(1);
+
+	// Unlink from every level before giving up our claim
+	find(name, preds, succs);
+	release(node);
+	return CrudStatus::Ok;
+}
+
+//======================================
+//		Update
+//======================================
+
+// The record is replaced whole, readers keep the old one until they unpin
+CrudStatus CharacterSkipList::tryUpdate(const std::string& name, const Character& updated) {
+	EpochReclaimer::Guard guard;
+	SkipNode* node = findNode(name);
+	if (!node) return CrudStatus::NotFound;
+	Character* old = node->record.exchange(new Character(updated));
+	EpochReclaimer::retire(old, deleteRecord);
+	return CrudStatus::Ok;
+}
+
+// Patches a private copy and swaps it in, retrying if another
+// writer swapped first so no change is lost
+CrudStatus CharacterSkipList::tryPatch(const std::string& name, const std::function<void(Character&)>& mutator) {
+	EpochReclaimer::Guard guard;
+	SkipNode* node = findNode(name);
+	if (!node) return CrudStatus::NotFound;
+	Character* old = node->record.load();
+	Character* fresh = new Character(*old);
+	mutator(*fresh);
+	while (!node->record.compare_exchange_strong(old, fresh)) {
+		*fresh = *old;
+		mutator(*fresh);
+	}
+	EpochReclaimer::retire(old, deleteRecord);
+	return CrudStatus::Ok;
+}
+
+//======================================
+//		Reads
+//======================================
+Character* CharacterSkipList::search(const std::string& name) {
+	EpochReclaimer::Guard guard;
+	SkipNode* node = findNode(name);
+	return node ? node->record.load() : nullptr;
+}
+
+const Character* CharacterSkipList::search(const std::string& name) const {
+	EpochReclaimer::Guard guard;
+	SkipNode* node = findNode(name);
+	return node ? node->record.load() : nullptr;
+}
+
+bool CharacterSkipList::lookup(const std::string& name, Character& out) const {
+	EpochReclaimer::Guard guard;
+	SkipNode* node = findNode(name);
+	if (!node) return false;
+	out = *node->record.load();
+	return true;
+}
+
+bool CharacterSkipList::visit(const std::string& name, const std::function<void(const Character&)>& fn) const {
+	EpochReclaimer::Guard guard;
+	SkipNode* node = findNode(name);
+	if (!node) return false;
+	fn(*node->record.load());
+	return true;
+}
+
+// Level 0 in order, concurrent changes may or may not be seen
+void CharacterSkipList::forEachInOrder(const std::function<void(const Character&)>& fn) const {
+	EpochReclaimer::Guard guard;
+	SkipNode* curr = target(head->next[0].load());
+	while (curr) {
+		Link succ = curr->next[0].load();
+		if (!marked(succ)) fn(*curr->record.load());
+		curr = target(succ);
+	}
+}
+
+void CharacterSkipList::displayAll() {
+	bool any = false;
+	forEachInOrder([&](const Character& c) {
+		std::cout << "Character: " << c.name
+			<< " | Gun DPS: " << c.gunDPS
+			<< " | Health: " << c.health << std::endl;
+		any = true;
+		});
+	if (!any) std::cout << "Database is empty." << std::endl;
+}
+
+//======================================
+//		Bulk
+//======================================
+
+// Sorted input links in one pass, tracking the last node per level
+void CharacterSkipList::buildFromSorted(std::vector<Character>& sorted) {
+	if (!empty()) {
+		throw std::runtime_error("Build failed: skip list is not empty.");
+	}
+	SkipNode* last[maxLevel];
+	for (int level = 0; level < maxLevel; ++level) last[level] = head;
+	for (Character& c : sorted) {
+		Character* record = new Character(std::move(c));
+		SkipNode* node = new SkipNode(record->name, record, randomHeight());
+		// Never shared with an inserter, only membership is left to release
+		node->owners.store(1);
+		for (int level = 0; level < node->height; ++level) {
+			last[level]->next[level].store(linkTo(node));
+			last[level] = node;
+		}
+	}
+	count.store(sorted.size());
+}
+
+void CharacterSkipList::clear() {
+	SkipNode* curr = target(head->next[0].load());
+	while (curr) {
+		SkipNode* next = target(curr->next[0].load());
+		delete curr;
+		curr = next;
+	}
+	for (int level = 0; level < maxLevel; ++level) head->next[level].store(0);
+	count.store(0);
+}
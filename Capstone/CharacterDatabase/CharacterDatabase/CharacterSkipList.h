@@ -0,0 +1,94 @@
+// ===========================================================
+// Capstone Project
+// CRUD Functionality - BST - SQLite - Html Report
+// Author: Austin Thompson
+// ------------------------------------------------------
+// Description: Lock free skip list keyed by character name.
+// Links carry a delete mark in their low bit, removal marks
+// a node then unlinks it, and unlinked nodes are freed
+// through the epoch reclaimer once no reader can see them.
+//-------------------------------------------------------
+// ===========================================================
+
+#ifndef CHARACTER_SKIP_LIST_H
+#define CHARACTER_SKIP_LIST_H
+
+#include "Character.h"
+#include <atomic>
+#include <cstdint>
+
+//==================================
+// Character Skip List Class
+// Every operation is safe from any
+// thread. search pointers, buildFromSorted
+// and clear need no concurrent writers.
+//==================================
+class CharacterSkipList : public CharacterIndex {
+private:
+    static const int maxLevel = 24;
+
+    struct SkipNode;
+    typedef uintptr_t Link;                             //SkipNode* with the mark in bit 0
+
+    struct SkipNode {
+        const std::string key;
+        std::atomic<Character*> record;                 //Swapped whole on update
+        const int height;
+        std::atomic<int> owners;                        //Inserter and membership, last one retires
+        std::atomic<Link>* next;
+
+        SkipNode(const std::string& key, Character* record, int height);
+        ~SkipNode();
+    };
+
+    SkipNode* head;                                     //Sentinel below every name
+    std::atomic<size_t> count;
+
+    static SkipNode* target(Link link) { return reinterpret_cast<SkipNode*>(link & ~Link(1)); }
+    static bool marked(Link link) { return (link & 1) != 0; }
+    static Link linkTo(SkipNode* node) { return reinterpret_cast<Link>(node); }
+
+    static int randomHeight();
+    static void deleteNode(void* node);
+    static void deleteRecord(void* record);
+    void release(SkipNode* node);
+
+    // Fills preds and succs around name on every level, unlinking
+    // marked nodes on the way. True if an unmarked match is succs[0].
+    bool find(const std::string& name, SkipNode** preds, SkipNode** succs);
+    // Links a copy of c, or moves from movable (which is c) when given.
+    // A record moved in is moved back if a racing insert wins.
+    CrudStatus insertRecord(const Character& c, Character* movable);
+    // Read only search that steps over marked nodes
+    SkipNode* findNode(const std::string& name) const;
+
+public:
+    CharacterSkipList();
+    ~CharacterSkipList();
+
+    CharacterSkipList(const CharacterSkipList&) = delete;
+    CharacterSkipList& operator=(const CharacterSkipList&) = delete;
+
+    //Interface functions
+    CrudStatus tryInsert(const Character& c) override;
+    CrudStatus tryInsert(Character&& c) override;
+    CrudStatus tryUpdate(const std::string& name, const Character& updated) override;
+    CrudStatus tryRemove(const std::string& name) override;
+    CrudStatus tryPatch(const std::string& name, const std::function<void(Character&)>& mutator) override;
+    Character* search(const std::string& name) override;
+    const Character* search(const std::string& name) const override;
+    void displayAll() override;
+
+    void buildFromSorted(std::vector<Character>& sorted) override;
+    bool empty() const override { return count.load() == 0; }
+    size_t size() const override { return count.load(); }
+    void clear() override;
+
+    bool lookup(const std::string& name, Character& out) const override;
+    bool visit(const std::string& name, const std::function<void(const Character&)>& fn) const override;
+    void forEachInOrder(const std::function<void(const Character&)>& fn) const override;
+
+    bool isConcurrent() const override { return true; }
+};
+
+#endif
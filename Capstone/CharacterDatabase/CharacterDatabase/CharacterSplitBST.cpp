@@ -0,0 +1,269 @@
+// ===========================================================
+// Capstone Project
+// CRUD Functionality - BST - SQLite - Html Report
+// Author: Austin Thompson
+// ------------------------------------------------------
+// Description: BST with key only nodes and split record storage.
+//-------------------------------------------------------
+// ===========================================================
+
+#include "CharacterSplitBST.h"
+#include <stdexcept>
+
+CharacterSplitBST::CharacterSplitBST() : root(nullptr), count(0) {}
+CharacterSplitBST::~CharacterSplitBST() { destroy(root); }
+
+//======================================
+//		Record Storage
+//======================================
+
+// Reuses the row of a removed record before growing
+uint32_t CharacterSplitBST::allocSlot() {
+	if (!freeSlots.empty()) {
+		uint32_t slot = freeSlots.back();
+		freeSlots.pop_back();
+		return slot;
+	}
+	hot.emplace_back();
+	cold.emplace_back();
+	return static_cast<uint32_t>(hot.size() - 1);
+}
+
+uint32_t CharacterSplitBST::store(const Character& c) {
+	uint32_t slot = allocSlot();
+	write(slot, c);
+	return slot;
+}
+
+// Unchanged abilities keep their ids without a pool lookup
+void CharacterSplitBST::write(uint32_t slot, const Character& c) {
+	hot[slot] = statsOf(c);
+	ColdText& text = cold[slot];
+	text.ability1 = abilityText.reintern(text.ability1, c.ability1);
+	text.ability2 = abilityText.reintern(text.ability2, c.ability2);
+	text.ability3 = abilityText.reintern(text.ability3, c.ability3);
+	text.ability4 = abilityText.reintern(text.ability4, c.ability4);
+}
+
+void CharacterSplitBST::assemble(const KeyNode* node, Character& out) const {
+	const ColdText& text = cold[node->slot];
+	out.name = node->key;
+	out.ability1 = abilityText.text(text.ability1);
+	out.ability2 = abilityText.text(text.ability2);
+	out.ability3 = abilityText.text(text.ability3);
+	out.ability4 = abilityText.text(text.ability4);
+	setStats(out, hot[node->slot]);
+}
+
+//======================================
+//		Searching
+//======================================
+
+// Descent compares keys only, the records stay out of cache
+const CharacterSplitBST::KeyNode* CharacterSplitBST::find(const std::string& name) const {
+	const KeyNode* node = root;
+	while (node) {
+		int cmp = name.compare(node->key);
+		if (cmp == 0) return node;
+		node = cmp < 0 ? node->left : node->right;
+	}
+	return nullptr;
+}
+
+CharacterSplitBST::KeyNode** CharacterSplitBST::insertLink(const std::string& name) {
+	KeyNode** link = &root;
+	while (*link) {
+		int cmp = name.compare((*link)->key);
+		if (cmp == 0) return nullptr;
+		link = cmp < 0 ? &(*link)->left : &(*link)->right;
+	}
+	return link;
+}
+
+// No record is stored whole, so there is nothing to point at
+Character* CharacterSplitBST::search(const std::string&) {
+	throw std::runtime_error("Search failed: split index stores no whole records, use lookup.");
+}
+const Character* CharacterSplitBST::search(const std::string&) const {
+	throw std::runtime_error("Search failed: split index stores no whole records, use lookup.");
+}
+
+bool CharacterSplitBST::lookup(const std::string& name, Character& out) const {
+	const KeyNode* node = find(name);
+	if (!node) return false;
+	assemble(node, out);
+	return true;
+}
+
+bool CharacterSplitBST::lookupStats(const std::string& name, CharacterStats& out) const {
+	const KeyNode* node = find(name);
+	if (!node) return false;
+	out = hot[node->slot];
+	return true;
+}
+
+bool CharacterSplitBST::visit(const std::string& name, const std::function<void(const Character&)>& fn) const {
+	Character c;
+	if (!lookup(name, c)) return false;
+	fn(c);
+	return true;
+}
+
+//======================================
+//		Changes
+//======================================
+CrudStatus CharacterSplitBST::tryInsert(const Character& c) {
+	KeyNode** link = insertLink(c.name);
+	if (!link) return CrudStatus::Duplicate;
+	uint32_t slot = store(c);
+	*link = pool.create(c.name, slot);
+	++count;
+	return CrudStatus::Ok;
+}
+
+CrudStatus CharacterSplitBST::tryInsert(Character&& c) {
+	KeyNode** link = insertLink(c.name);
+	if (!link) return CrudStatus::Duplicate;
+	// Interned text is copied once per distinct string, moving gains nothing
+	*link = pool.create(c.name, store(c));
+	++count;
+	return CrudStatus::Ok;
+}
+
+CrudStatus CharacterSplitBST::tryUpdate(const std::string& name, const Character& updated) {
+	const KeyNode* node = find(name);
+	if (!node) return CrudStatus::NotFound;
+	write(node->slot, updated);
+	return CrudStatus::Ok;
+}
+
+// Stat only patches touch just the hot row
+CrudStatus CharacterSplitBST::tryPatch(const std::string& name, const std::function<void(Character&)>& mutator) {
+	const KeyNode* node = find(name);
+	if (!node) return CrudStatus::NotFound;
+	Character c;
+	assemble(node, c);
+	mutator(c);
+	write(node->slot, c);
+	return CrudStatus::Ok;
+}
+
+// Same relinking as CharacterBST, the freed row is kept for reuse
+CrudStatus CharacterSplitBST::tryRemove(const std::string& name) {
+	KeyNode** link = &root;
+	while (*link) {
+		int cmp = name.compare((*link)->key);
+		if (cmp == 0) break;
+		link = cmp < 0 ? &(*link)->left : &(*link)->right;
+	}
+	KeyNode* node = *link;
+	if (!node) return CrudStatus::NotFound;
+
+	if (!node->left) {
+		*link = node->right;
+	}
+	else if (!node->right) {
+		*link = node->left;
+	}
+	else {
+		KeyNode** minLink = &node->right;
+		while ((*minLink)->left) minLink = &(*minLink)->left;
+		KeyNode* minRight = *minLink;
+		*minLink = minRight->right;
+		minRight->left = node->left;
+		minRight->right = node->right;
+		*link = minRight;
+	}
+	ColdText& text = cold[node->slot];
+	abilityText.release(text.ability1);
+	abilityText.release(text.ability2);
+	abilityText.release(text.ability3);
+	abilityText.release(text.ability4);
+	text = ColdText();
+	freeSlots.push_back(node->slot);
+	pool.destroy(node);
+	--count;
+	return CrudStatus::Ok;
+}
+
+//======================================
+//		Traversal
+//======================================
+void CharacterSplitBST::inorder(const KeyNode* node, const std::function<void(const KeyNode*)>& fn) const {
+	if (!node) return;
+	inorder(node->left, fn);
+	fn(node);
+	inorder(node->right, fn);
+}
+
+void CharacterSplitBST::forEachInOrder(const std::function<void(const Character&)>& fn) const {
+	Character c;
+	inorder(root, [&](const KeyNode* node) {
+		assemble(node, c);
+		fn(c);
+		});
+}
+
+// Prints hot fields only
+void CharacterSplitBST::displayAll() {
+	if (!root) {
+		std::cout << "Database is empty." << std::endl;
+		return;
+	}
+	inorder(root, [&](const KeyNode* node) {
+		const CharacterStats& stats = hot[node->slot];
+		std::cout << "Character: " << node->key
+			<< " | Gun DPS: " << stats.gunDPS
+			<< " | Health: " << stats.health << std::endl;
+		});
+}
+
+//======================================
+//		Bulk
+//======================================
+void CharacterSplitBST::destroy(KeyNode* node) {
+	if (node) {
+		destroy(node->left);
+		destroy(node->right);
+		pool.destroy(node);
+	}
+}
+
+void CharacterSplitBST::clear() {
+	destroy(root);
+	root = nullptr;
+	count = 0;
+	hot.clear();
+	cold.clear();
+	abilityText.clear();
+	freeSlots.clear();
+}
+
+// Rows are laid out in name order, so in order walks read hot sequentially
+CharacterSplitBST::KeyNode* CharacterSplitBST::buildBalanced(std::vector<Character>& sorted, size_t lo, size_t hi) {
+	if (lo >= hi) return nullptr;
+	size_t mid = lo + (hi - lo) / 2;
+	KeyNode* node = pool.create(sorted[mid].name, static_cast<uint32_t>(mid));
+	node->left = buildBalanced(sorted, lo, mid);
+	node->right = buildBalanced(sorted, mid + 1, hi);
+	return node;
+}
+
+void CharacterSplitBST::buildFromSorted(std::vector<Character>& sorted) {
+	if (root) {
+		throw std::runtime_error("Build failed: tree is not empty.");
+	}
+	hot.clear();
+	cold.clear();
+	abilityText.clear();
+	freeSlots.clear();
+	hot.reserve(sorted.size());
+	cold.reserve(sorted.size());
+	root = buildBalanced(sorted, 0, sorted.size());
+	for (Character& c : sorted) {
+		hot.push_back(statsOf(c));
+		cold.push_back({ abilityText.intern(c.ability1), abilityText.intern(c.ability2),
+			abilityText.intern(c.ability3), abilityText.intern(c.ability4) });
+	}
+	count = sorted.size();
+}
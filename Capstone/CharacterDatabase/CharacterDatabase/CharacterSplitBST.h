@@ -0,0 +1,96 @@
+// ===========================================================
+// Capstone Project
+// CRUD Functionality - BST - SQLite - Html Report
+// Author: Austin Thompson
+// ------------------------------------------------------
+// Description: BST keyed by character name that keeps the
+// record out of the tree. Nodes hold the key, a slot number
+// and child links, about one cache line each; numeric stats
+// live in a packed hot array and ability text ids in a cold
+// array, both indexed by slot. Ability text is interned, so a
+// name shared by many characters is stored once.
+//-------------------------------------------------------
+// ===========================================================
+
+#ifndef CHARACTER_SPLIT_BST_H
+#define CHARACTER_SPLIT_BST_H
+
+#include "Character.h"
+#include "StringPool.h"
+#include <cstdint>
+
+//==================================
+// Character Split BST Class
+// Records are assembled on read, so
+// search pointers are not available;
+// use lookup, visit or contains.
+//==================================
+class CharacterSplitBST : public CharacterIndex {
+private:
+    struct KeyNode {
+        std::string key;
+        uint32_t slot;                                  //Row in hot and cold
+        KeyNode* left;
+        KeyNode* right;
+
+        KeyNode(const std::string& key, uint32_t slot) : key(key), slot(slot), left(nullptr), right(nullptr) {}
+    };
+
+    // Ability text ids, only read when a whole record is asked for
+    struct ColdText {
+        StringId ability1 = 0;
+        StringId ability2 = 0;
+        StringId ability3 = 0;
+        StringId ability4 = 0;
+    };
+
+    KeyNode* root;
+    size_t count;
+    ObjectPool<KeyNode> pool;
+    std::vector<CharacterStats> hot;
+    std::vector<ColdText> cold;
+    StringPool abilityText;                             //One reference per ability of a live row
+    std::vector<uint32_t> freeSlots;                    //Rows of removed records
+
+    const KeyNode* find(const std::string& name) const;
+    KeyNode** insertLink(const std::string& name);      //Empty link where name belongs, null if taken
+    uint32_t allocSlot();
+    uint32_t store(const Character& c);
+    void write(uint32_t slot, const Character& c);
+    void assemble(const KeyNode* node, Character& out) const;
+    void inorder(const KeyNode* node, const std::function<void(const KeyNode*)>& fn) const;
+    void destroy(KeyNode* node);
+    KeyNode* buildBalanced(std::vector<Character>& sorted, size_t lo, size_t hi);
+
+public:
+    CharacterSplitBST();
+    ~CharacterSplitBST();
+
+    CharacterSplitBST(const CharacterSplitBST&) = delete;
+    CharacterSplitBST& operator=(const CharacterSplitBST&) = delete;
+
+    //Interface functions
+    CrudStatus tryInsert(const Character& c) override;
+    CrudStatus tryInsert(Character&& c) override;
+    CrudStatus tryUpdate(const std::string& name, const Character& updated) override;
+    CrudStatus tryRemove(const std::string& name) override;
+    CrudStatus tryPatch(const std::string& name, const std::function<void(Character&)>& mutator) override;
+    Character* search(const std::string& name) override;
+    const Character* search(const std::string& name) const override;
+    void displayAll() override;
+
+    void buildFromSorted(std::vector<Character>& sorted) override;
+    bool empty() const override { return root == nullptr; }
+    size_t size() const override { return count; }
+    void clear() override;
+
+    bool lookup(const std::string& name, Character& out) const override;
+    bool visit(const std::string& name, const std::function<void(const Character&)>& fn) const override;
+    void forEachInOrder(const std::function<void(const Character&)>& fn) const override;
+    bool contains(const std::string& name) const override { return find(name) != nullptr; }
+
+    // Hot path reads that never touch the ability text
+    bool lookupStats(const std::string& name, CharacterStats& out) const;
+};
+
+#endif
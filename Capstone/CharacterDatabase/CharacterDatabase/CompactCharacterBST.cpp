@@ -0,0 +1,240 @@
+// ===========================================================
+// Capstone Project
+// CRUD Functionality - BST - SQLite - Html Report
+// Author: Austin Thompson
+// ------------------------------------------------------
+// Description: BST with 32 bit slot links in one vector.
+//-------------------------------------------------------
+// ===========================================================
+
+#include "CompactCharacterBST.h"
+#include <stdexcept>
+
+CompactCharacterBST::CompactCharacterBST() : root(none), freeSlots(none), count(0) {}
+
+// Differing prefixes decide without reading the name bytes on the heap
+int CompactCharacterBST::compare(const CompactNode& node, const std::string& name, uint64_t key) const {
+	if (key != node.prefix) return key < node.prefix ? -1 : 1;
+	return name.compare(node.data.name);
+}
+
+//======================================
+//		Insert
+//======================================
+
+// Grows the vector before a descent, so the link it returns is not
+// moved by the push_back in newSlot
+void CompactCharacterBST::reserveSlot() {
+	if (freeSlots != none || nodes.size() < nodes.capacity()) return;
+	if (nodes.size() >= none) {
+		throw std::runtime_error("Insert failed: compact tree is full.");
+	}
+	nodes.reserve(nodes.size() < 16 ? 16 : nodes.size() * 2);
+}
+
+// Free chain first, then the reserved end of the vector
+uint32_t CompactCharacterBST::newSlot(const std::string& name) {
+	uint32_t slot = freeSlots;
+	if (slot != none) {
+		freeSlots = nodes[slot].left;
+	}
+	else {
+		slot = static_cast<uint32_t>(nodes.size());
+		nodes.push_back(CompactNode());
+	}
+	nodes[slot].prefix = namePrefix(name);
+	nodes[slot].left = nodes[slot].right = none;
+	++count;
+	return slot;
+}
+
+// Walks down to the empty link, one compare per level
+uint32_t* CompactCharacterBST::insertLink(const std::string& name) {
+	const uint64_t key = namePrefix(name);
+	uint32_t* link = &root;
+	while (*link != none) {
+		CompactNode& node = nodes[*link];
+		int cmp = compare(node, name, key);
+		if (cmp == 0) return nullptr;
+		link = cmp < 0 ? &node.left : &node.right;
+	}
+	return link;
+}
+
+// Duplicate names are reported, not thrown
+CrudStatus CompactCharacterBST::tryInsert(const Character& c) {
+	reserveSlot();
+	uint32_t* link = insertLink(c.name);
+	if (!link) return CrudStatus::Duplicate;
+	uint32_t slot = newSlot(c.name);
+	nodes[slot].data = c;
+	*link = slot;
+	return CrudStatus::Ok;
+}
+
+CrudStatus CompactCharacterBST::tryInsert(Character&& c) {
+	reserveSlot();
+	uint32_t* link = insertLink(c.name);
+	if (!link) return CrudStatus::Duplicate;
+	uint32_t slot = newSlot(c.name);
+	nodes[slot].data = std::move(c);
+	*link = slot;
+	return CrudStatus::Ok;
+}
+
+//======================================
+//		Search
+//======================================
+uint32_t CompactCharacterBST::find(const std::string& name) const {
+	const uint64_t key = namePrefix(name);
+	uint32_t slot = root;
+	while (slot != none) {
+		const CompactNode& node = nodes[slot];
+		int cmp = compare(node, name, key);
+		if (cmp == 0) return slot;
+		slot = cmp < 0 ? node.left : node.right;
+	}
+	return none;
+}
+
+Character* CompactCharacterBST::search(const std::string& name) {
+	uint32_t slot = find(name);
+	return slot != none ? &nodes[slot].data : nullptr;
+}
+
+const Character* CompactCharacterBST::search(const std::string& name) const {
+	uint32_t slot = find(name);
+	return slot != none ? &nodes[slot].data : nullptr;
+}
+
+bool CompactCharacterBST::lookup(const std::string& name, Character& out) const {
+	uint32_t slot = find(name);
+	if (slot == none) return false;
+	out = nodes[slot].data;
+	return true;
+}
+
+bool CompactCharacterBST::visit(const std::string& name, const std::function<void(const Character&)>& fn) const {
+	uint32_t slot = find(name);
+	if (slot == none) return false;
+	fn(nodes[slot].data);
+	return true;
+}
+
+void CompactCharacterBST::inorder(uint32_t slot, const std::function<void(const Character&)>& fn) const {
+	if (slot == none) return;
+	inorder(nodes[slot].left, fn);
+	fn(nodes[slot].data);
+	inorder(nodes[slot].right, fn);
+}
+
+void CompactCharacterBST::forEachInOrder(const std::function<void(const Character&)>& fn) const {
+	inorder(root, fn);
+}
+
+void CompactCharacterBST::displayAll() {
+	if (root == none) {
+		std::cout << "Database is empty." << std::endl;
+		return;
+	}
+	forEachInOrder([](const Character& c) {
+		std::cout << "Character: " << c.name
+			<< " | Gun DPS: " << c.gunDPS
+			<< " | Health: " << c.health << std::endl;
+		});
+}
+
+//======================================
+//		Update and Remove
+//======================================
+CrudStatus CompactCharacterBST::tryUpdate(const std::string& name, const Character& updated) {
+	uint32_t slot = find(name);
+	if (slot == none) return CrudStatus::NotFound;
+	nodes[slot].data = updated;
+	nodes[slot].prefix = namePrefix(updated.name);
+	return CrudStatus::Ok;
+}
+
+CrudStatus CompactCharacterBST::tryPatch(const std::string& name, const std::function<void(Character&)>& mutator) {
+	uint32_t slot = find(name);
+	if (slot == none) return CrudStatus::NotFound;
+	mutator(nodes[slot].data);
+	nodes[slot].prefix = namePrefix(nodes[slot].data.name);
+	return CrudStatus::Ok;
+}
+
+// Same relinking as CharacterBST, the freed slot joins the free chain
+CrudStatus CompactCharacterBST::tryRemove(const std::string& name) {
+	const uint64_t key = namePrefix(name);
+	uint32_t* link = &root;
+	while (*link != none) {
+		CompactNode& node = nodes[*link];
+		int cmp = compare(node, name, key);
+		if (cmp == 0) break;
+		link = cmp < 0 ? &node.left : &node.right;
+	}
+	uint32_t slot = *link;
+	if (slot == none) return CrudStatus::NotFound;
+
+	CompactNode& node = nodes[slot];
+	if (node.left == none) {
+		*link = node.right;
+	}
+	else if (node.right == none) {
+		*link = node.left;
+	}
+	else {
+		uint32_t* minLink = &node.right;
+		while (nodes[*minLink].left != none) minLink = &nodes[*minLink].left;
+		uint32_t minRight = *minLink;
+		*minLink = nodes[minRight].right;
+		nodes[minRight].left = node.left;
+		nodes[minRight].right = node.right;
+		*link = minRight;
+	}
+	node.data = Character();
+	node.right = none;
+	node.left = freeSlots;
+	freeSlots = slot;
+	--count;
+	return CrudStatus::Ok;
+}
+
+//======================================
+//		Build and Clear
+//======================================
+
+// Slots are handed out in preorder, so the top levels share lines
+uint32_t CompactCharacterBST::buildBalanced(std::vector<Character>& sorted, size_t lo, size_t hi) {
+	if (lo >= hi) return none;
+	size_t mid = lo + (hi - lo) / 2;
+	uint32_t slot = static_cast<uint32_t>(nodes.size());
+	nodes.push_back(CompactNode());
+	nodes[slot].prefix = namePrefix(sorted[mid].name);
+	nodes[slot].data = std::move(sorted[mid]);
+	uint32_t left = buildBalanced(sorted, lo, mid);
+	uint32_t right = buildBalanced(sorted, mid + 1, hi);
+	nodes[slot].left = left;
+	nodes[slot].right = right;
+	return slot;
+}
+
+void CompactCharacterBST::buildFromSorted(std::vector<Character>& sorted) {
+	if (count) {
+		throw std::runtime_error("Build failed: tree is not empty.");
+	}
+	if (sorted.size() >= none) {
+		throw std::runtime_error("Build failed: too many records for a compact tree.");
+	}
+	clear();
+	nodes.reserve(sorted.size());
+	root = buildBalanced(sorted, 0, sorted.size());
+	count = sorted.size();
+}
+
+void CompactCharacterBST::clear() {
+	std::vector<CompactNode>().swap(nodes);
+	root = none;
+	freeSlots = none;
+	count = 0;
+}
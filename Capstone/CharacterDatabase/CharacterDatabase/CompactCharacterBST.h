@@ -0,0 +1,73 @@
+// ===========================================================
+// Capstone Project
+// CRUD Functionality - BST - SQLite - Html Report
+// Author: Austin Thompson
+// ------------------------------------------------------
+// Description: Binary search tree whose nodes live in one
+// vector and name their children by 32 bit slot number
+// instead of pointer. Links take 8 bytes a node instead of
+// 16, there is no per node allocation, and a node can be
+// copied or moved anywhere without fixing up its links.
+//-------------------------------------------------------
+// ===========================================================
+
+#ifndef COMPACT_CHARACTER_BST_H
+#define COMPACT_CHARACTER_BST_H
+
+#include "Character.h"
+#include <cstdint>
+
+//==================================
+// Compact Character BST Class
+// Growing the vector moves every
+// record, so search pointers are only
+// good until the next insert
+//==================================
+class CompactCharacterBST : public CharacterIndex {
+private:
+    static const uint32_t none = UINT32_MAX;
+
+    struct CompactNode {
+        uint64_t prefix;                                //namePrefix(data.name)
+        uint32_t left;                                  //Slot numbers, none for no child
+        uint32_t right;
+        Character data;
+    };
+
+    std::vector<CompactNode> nodes;
+    uint32_t root;
+    uint32_t freeSlots;                                 //Removed slots chained through left
+    size_t count;
+
+    int compare(const CompactNode& node, const std::string& name, uint64_t key) const;
+    uint32_t find(const std::string& name) const;
+    uint32_t* insertLink(const std::string& name);      //Empty link where name belongs, null if taken
+    void reserveSlot();
+    uint32_t newSlot(const std::string& name);
+    void inorder(uint32_t slot, const std::function<void(const Character&)>& fn) const;
+    uint32_t buildBalanced(std::vector<Character>& sorted, size_t lo, size_t hi);
+
+public:
+    CompactCharacterBST();
+
+    //Interface functions
+    CrudStatus tryInsert(const Character& c) override;
+    CrudStatus tryInsert(Character&& c) override;
+    CrudStatus tryUpdate(const std::string& name, const Character& updated) override;
+    CrudStatus tryRemove(const std::string& name) override;
+    CrudStatus tryPatch(const std::string& name, const std::function<void(Character&)>& mutator) override;
+    Character* search(const std::string& name) override;
+    const Character* search(const std::string& name) const override;
+    void displayAll() override;
+
+    void buildFromSorted(std::vector<Character>& sorted) override;
+    bool empty() const override { return count == 0; }
+    size_t size() const override { return count; }
+    void clear() override;
+
+    bool lookup(const std::string& name, Character& out) const override;
+    bool visit(const std::string& name, const std::function<void(const Character&)>& fn) const override;
+    void forEachInOrder(const std::function<void(const Character&)>& fn) const override;
+};
+
+#endif
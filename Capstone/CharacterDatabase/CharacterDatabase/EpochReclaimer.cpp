@@ -0,0 +1,126 @@
+// ===========================================================
+// Capstone Project
+// CRUD Functionality - BST - SQLite - Html Report
+// Author: Austin Thompson
+// ------------------------------------------------------
+// Description: Epoch based memory reclamation.
+//-------------------------------------------------------
+// ===========================================================
+
+#include "EpochReclaimer.h"
+#include <algorithm>
+#include <stdexcept>
+
+EpochReclaimer::Slot EpochReclaimer::slots[EpochReclaimer::maxThreads];
+std::atomic<uint64_t> EpochReclaimer::globalEpoch(0);
+std::mutex EpochReclaimer::orphanLock;
+std::vector<EpochReclaimer::Retired> EpochReclaimer::orphans;
+EpochReclaimer::ExitCleanup EpochReclaimer::exitCleanup;
+
+// Runs after main returns, other threads must be done by then
+EpochReclaimer::ExitCleanup::~ExitCleanup() {
+	std::lock_guard<std::mutex> lock(orphanLock);
+	for (const Retired& r : orphans) r.deleter(r.ptr);
+	orphans.clear();
+}
+
+//======================================
+//		Thread Registration
+//======================================
+EpochReclaimer::ThreadState::ThreadState() : slot(maxThreads), depth(0) {
+	for (size_t i = 0; i < maxThreads; ++i) {
+		bool expected = false;
+		if (slots[i].used.compare_exchange_strong(expected, true)) {
+			slot = i;
+			slots[i].state.store(0);
+			return;
+		}
+	}
+	throw std::runtime_error("Epoch reclaimer: too many threads.");
+}
+
+// Retired memory outlives the thread, a later collect frees it
+EpochReclaimer::ThreadState::~ThreadState() {
+	slots[slot].state.store(0);
+	if (!retired.empty()) {
+		std::lock_guard<std::mutex> lock(orphanLock);
+		orphans.insert(orphans.end(), retired.begin(), retired.end());
+	}
+	slots[slot].used.store(false);
+}
+
+EpochReclaimer::ThreadState& EpochReclaimer::local() {
+	static thread_local ThreadState state;
+	return state;
+}
+
+//======================================
+//		Pinning
+//======================================
+EpochReclaimer::Guard::Guard() {
+	ThreadState& t = local();
+	if (t.depth++ == 0) {
+		slots[t.slot].state.store((globalEpoch.load() << 1) | 1);
+	}
+}
+
+EpochReclaimer::Guard::~Guard() {
+	ThreadState& t = local();
+	if (--t.depth == 0) slots[t.slot].state.store(0);
+}
+
+//======================================
+//		Reclamation
+//======================================
+
+// The epoch moves on once every pinned thread has seen the current one
+bool EpochReclaimer::tryAdvance() {
+	uint64_t epoch = globalEpoch.load();
+	for (size_t i = 0; i < maxThreads; ++i) {
+		uint64_t state = slots[i].state.load();
+		if ((state & 1) && (state >> 1) != epoch) return false;
+	}
+	globalEpoch.compare_exchange_strong(epoch, epoch + 1);
+	return true;
+}
+
+// Anything retired two epochs back can no longer be reached
+void EpochReclaimer::freeUpTo(std::vector<Retired>& list, uint64_t safeEpoch) {
+	auto keep = std::partition(list.begin(), list.end(), [&](const Retired& r) { return r.epoch + 2 > safeEpoch; });
+	std::vector<Retired> ready(keep, list.end());
+	list.erase(keep, list.end());
+	for (const Retired& r : ready) r.deleter(r.ptr);
+}
+
+void EpochReclaimer::retire(void* ptr, Deleter deleter) {
+	ThreadState& t = local();
+	t.retired.push_back({ ptr, deleter, globalEpoch.load() });
+	if (t.retired.size() % collectEvery == 0) {
+		tryAdvance();
+		uint64_t epoch = globalEpoch.load();
+		freeUpTo(t.retired, epoch);
+		freeOrphans(epoch);
+	}
+}
+
+void EpochReclaimer::freeOrphans(uint64_t safeEpoch) {
+	std::vector<Retired> ready;
+	{
+		std::unique_lock<std::mutex> lock(orphanLock, std::try_to_lock);
+		if (!lock.owns_lock() || orphans.empty()) return;
+		ready.swap(orphans);
+	}
+	freeUpTo(ready, safeEpoch);
+	if (!ready.empty()) {
+		std::lock_guard<std::mutex> lock(orphanLock);
+		orphans.insert(orphans.end(), ready.begin(), ready.end());
+	}
+}
+
+void EpochReclaimer::collect() {
+	tryAdvance();
+	tryAdvance();
+	uint64_t epoch = globalEpoch.load();
+	freeUpTo(local().retired, epoch);
+	freeOrphans(epoch);
+}
@@ -0,0 +1,89 @@
+// ===========================================================
+// Capstone Project
+// CRUD Functionality - BST - SQLite - Html Report
+// Author: Austin Thompson
+// ------------------------------------------------------
+// Description: Epoch based memory reclamation for lock
+// free structures. Readers pin the current epoch while
+// they hold pointers, retired memory is freed once every
+// pinned thread has moved two epochs past its removal.
+//-------------------------------------------------------
+// ===========================================================
+
+#ifndef EPOCH_RECLAIMER_H
+#define EPOCH_RECLAIMER_H
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+//==================================
+// Epoch Reclaimer Class
+// One process wide domain, each thread
+// claims a slot on first use
+//==================================
+class EpochReclaimer {
+public:
+    typedef void (*Deleter)(void*);
+
+    // Pins the calling thread for the guard's lifetime, nests freely
+    class Guard {
+    public:
+        Guard();
+        ~Guard();
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+    };
+
+    // Frees ptr with deleter once no pinned thread can still see it.
+    // Call after ptr is unreachable for new readers.
+    static void retire(void* ptr, Deleter deleter);
+
+    // Tries to advance the epoch and free what is safe, used by
+    // tests and at quiet points
+    static void collect();
+
+private:
+    struct Retired {
+        void* ptr;
+        Deleter deleter;
+        uint64_t epoch;
+    };
+
+    // Low bit set while the owning thread is pinned
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> state{ 0 };
+        std::atomic<bool> used{ false };
+    };
+
+    static const size_t maxThreads = 256;
+    static const size_t collectEvery = 64;
+
+    static Slot slots[maxThreads];
+    static std::atomic<uint64_t> globalEpoch;
+
+    // Memory left behind by exited threads, whatever is
+    // still there at exit is freed by exitCleanup
+    static std::mutex orphanLock;
+    static std::vector<Retired> orphans;
+    struct ExitCleanup {
+        ~ExitCleanup();
+    };
+    static ExitCleanup exitCleanup;
+
+    struct ThreadState {
+        size_t slot;
+        unsigned int depth;
+        std::vector<Retired> retired;
+        ThreadState();
+        ~ThreadState();
+    };
+    static ThreadState& local();
+
+    static bool tryAdvance();
+    static void freeUpTo(std::vector<Retired>& list, uint64_t safeEpoch);
+    static void freeOrphans(uint64_t safeEpoch);
+};
+
+#endif
@@ -0,0 +1,196 @@
+// ===========================================================
+// Capstone Project
+// CRUD Functionality - BST - SQLite - Html Report
+// Author: Austin Thompson
+// ------------------------------------------------------
+// Description: Eytzinger layout read only index.
+//-------------------------------------------------------
+// ===========================================================
+
+#include "FrozenCharacterIndex.h"
+#include <stdexcept>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#include <xmmintrin.h>
+#endif
+
+static void prefetch(const void* address) {
+#if defined(_MSC_VER)
+	_mm_prefetch(static_cast<const char*>(address), _MM_HINT_T0);
+#else
+	__builtin_prefetch(address);
+#endif
+}
+
+static int trailingOnes(uint64_t bits) {
+#if defined(_MSC_VER)
+	unsigned long index;
+	return _BitScanForward64(&index, ~bits) ? static_cast<int>(index) : 64;
+#else
+	return ~bits ? __builtin_ctzll(~bits) : 64;
+#endif
+}
+
+//======================================
+//		Build
+//======================================
+FrozenCharacterIndex::FrozenCharacterIndex(std::vector<Character>&& sorted) {
+	std::vector<Character> input = std::move(sorted);
+	buildFromSorted(input);
+}
+
+// In order walk of the implicit tree hands out sorted positions
+size_t FrozenCharacterIndex::layout(const std::vector<uint64_t>& sorted, size_t next, size_t slot) {
+	if (slot >= keys.size()) return next;
+	next = layout(sorted, next, 2 * slot);
+	keys[slot] = sorted[next];
+	rank[slot] = static_cast<uint32_t>(next);
+	++next;
+	return layout(sorted, next, 2 * slot + 1);
+}
+
+void FrozenCharacterIndex::buildFromSorted(std::vector<Character>& sorted) {
+	if (!records.empty()) {
+		throw std::runtime_error("Build failed: frozen index is not empty.");
+	}
+	records = std::move(sorted);
+	sorted.clear();
+	std::vector<uint64_t> prefixes;
+	prefixes.reserve(records.size());
+	for (const Character& c : records) prefixes.push_back(namePrefix(c.name));
+	keys.assign(records.size() + 1, 0);
+	rank.assign(records.size() + 1, static_cast<uint32_t>(records.size()));
+	layout(prefixes, 0, 1);
+
+	// Each hash slot stores its record position in just enough bits
+	names.build(records.size(), [this](size_t i) -> const std::string& { return records[i].name; });
+	positionBits = 1;
+	while ((size_t(1) << positionBits) < records.size()) ++positionBits;
+	packedPositions.assign((records.size() * positionBits + 63) / 64 + 1, 0);
+	for (size_t pos = 0; pos < records.size(); ++pos) {
+		size_t bit = static_cast<size_t>(names.slot(records[pos].name)) * positionBits;
+		packedPositions[bit >> 6] |= uint64_t(pos) << (bit & 63);
+		if ((bit & 63) + positionBits > 64) packedPositions[(bit >> 6) + 1] |= uint64_t(pos) >> (64 - (bit & 63));
+	}
+}
+
+std::vector<Character> FrozenCharacterIndex::release() {
+	std::vector<Character> out = std::move(records);
+	clear();
+	return out;
+}
+
+void FrozenCharacterIndex::clear() {
+	records.clear();
+	keys.clear();
+	rank.clear();
+	names.clear();
+	packedPositions.clear();
+	positionBits = 0;
+}
+
+//======================================
+//		Search
+//======================================
+
+// Position of the first record not below name. The walk goes left or
+// right by arithmetic only, and prefetches the line holding the slots
+// three levels down while that line is still inside the array (even
+// forming a pointer past it is undefined). The exit slot's trailing
+// right turns are undone to find the last left turn, the first prefix
+// not below the key.
+size_t FrozenCharacterIndex::lowerBound(const std::string& name) const {
+	const size_t n = records.size();
+	const uint64_t key = namePrefix(name);
+	const uint64_t* slots = keys.data();
+	const size_t slotCount = keys.size();
+	size_t k = 1;
+	while (k <= n) {
+		if (8 * k < slotCount) prefetch(slots + 8 * k);
+		k = 2 * k + (slots[k] < key);
+	}
+	k >>= trailingOnes(k) + 1;
+	size_t pos = k ? rank[k] : n;
+	// Names sharing the prefix are settled by a short scan
+	while (pos < n && records[pos].name < name) ++pos;
+	return pos;
+}
+
+size_t FrozenCharacterIndex::positionOf(uint32_t slot) const {
+	size_t bit = static_cast<size_t>(slot) * positionBits;
+	uint64_t value = packedPositions[bit >> 6] >> (bit & 63);
+	if ((bit & 63) + positionBits > 64) value |= packedPositions[(bit >> 6) + 1] << (64 - (bit & 63));
+	return static_cast<size_t>(value & ((uint64_t(1) << positionBits) - 1));
+}
+
+// Absent names still hash to some slot, the compare turns them away
+const Character* FrozenCharacterIndex::find(const std::string& name) const {
+	if (records.empty()) return nullptr;
+	const Character& record = records[positionOf(names.slot(name))];
+	return record.name == name ? &record : nullptr;
+}
+
+Character* FrozenCharacterIndex::search(const std::string& name) {
+	return const_cast<Character*>(find(name));
+}
+
+const Character* FrozenCharacterIndex::search(const std::string& name) const {
+	return find(name);
+}
+
+bool FrozenCharacterIndex::lookup(const std::string& name, Character& out) const {
+	const Character* record = find(name);
+	if (!record) return false;
+	out = *record;
+	return true;
+}
+
+bool FrozenCharacterIndex::visit(const std::string& name, const std::function<void(const Character&)>& fn) const {
+	const Character* record = find(name);
+	if (!record) return false;
+	fn(*record);
+	return true;
+}
+
+void FrozenCharacterIndex::forEachInOrder(const std::function<void(const Character&)>& fn) const {
+	for (const Character& c : records) fn(c);
+}
+
+// Matches are one run starting at the prefix's lower bound
+void FrozenCharacterIndex::forEachWithPrefix(const std::string& prefix, const std::function<void(const Character&)>& fn) const {
+	for (size_t pos = lowerBound(prefix); pos < records.size(); ++pos) {
+		if (records[pos].name.compare(0, prefix.size(), prefix) != 0) break;
+		fn(records[pos]);
+	}
+}
+
+void FrozenCharacterIndex::displayAll() {
+	if (records.empty()) {
+		std::cout << "Database is empty." << std::endl;
+		return;
+	}
+	for (const Character& c : records) {
+		std::cout << "Character: " << c.name
+			<< " | Gun DPS: " << c.gunDPS
+			<< " | Health: " << c.health << std::endl;
+	}
+}
+
+//======================================
+//		Changes
+//======================================
+CrudStatus FrozenCharacterIndex::tryInsert(const Character&) {
+	throw std::runtime_error("Insert failed: index is frozen.");
+}
+CrudStatus FrozenCharacterIndex::tryInsert(Character&&) {
+	throw std::runtime_error("Insert failed: index is frozen.");
+}
+CrudStatus FrozenCharacterIndex::tryUpdate(const std::string&, const Character&) {
+	throw std::runtime_error("Update failed: index is frozen.");
+}
+CrudStatus FrozenCharacterIndex::tryRemove(const std::string&) {
+	throw std::runtime_error("Delete failed: index is frozen.");
+}
+CrudStatus FrozenCharacterIndex::tryPatch(const std::string&, const std::function<void(Character&)>&) {
+	throw std::runtime_error("Update failed: index is frozen.");
+}
@@ -0,0 +1,72 @@
+// ===========================================================
+// Capstone Project
+// CRUD Functionality - BST - SQLite - Html Report
+// Author: Austin Thompson
+// ------------------------------------------------------
+// Description: Read only index for a roster that is not
+// changing. Records sit in one sorted array, and their 8
+// byte name prefixes are laid out in Eytzinger (breadth
+// first) order for ordered and prefix scans. Exact lookups
+// go through a minimal perfect hash over the names instead,
+// one slot computation and one name compare.
+//-------------------------------------------------------
+// ===========================================================
+
+#ifndef FROZEN_CHARACTER_INDEX_H
+#define FROZEN_CHARACTER_INDEX_H
+
+#include "Character.h"
+#include "PerfectNameHash.h"
+#include <cstdint>
+
+//==================================
+// Frozen Character Index Class
+// Any change throws, CharacterDatabase
+// thaws back to its backend first
+//==================================
+class FrozenCharacterIndex : public CharacterIndex {
+private:
+    std::vector<Character> records;                     //Sorted by name
+    std::vector<uint64_t> keys;                         //Eytzinger order, keys[0] unused
+    std::vector<uint32_t> rank;                         //Eytzinger slot to records position
+    PerfectNameHash names;
+    std::vector<uint64_t> packedPositions;              //Hash slot to records position, bit packed
+    unsigned positionBits = 0;
+
+    size_t layout(const std::vector<uint64_t>& sorted, size_t next, size_t slot);
+    size_t lowerBound(const std::string& name) const;
+    size_t positionOf(uint32_t slot) const;
+    const Character* find(const std::string& name) const;
+
+public:
+    // Takes records already sorted by name with no duplicates
+    explicit FrozenCharacterIndex(std::vector<Character>&& sorted);
+
+    FrozenCharacterIndex(const FrozenCharacterIndex&) = delete;
+    FrozenCharacterIndex& operator=(const FrozenCharacterIndex&) = delete;
+
+    // Hands the sorted records back and leaves the index empty
+    std::vector<Character> release();
+
+    //Interface functions
+    CrudStatus tryInsert(const Character& c) override;
+    CrudStatus tryInsert(Character&& c) override;
+    CrudStatus tryUpdate(const std::string& name, const Character& updated) override;
+    CrudStatus tryRemove(const std::string& name) override;
+    CrudStatus tryPatch(const std::string& name, const std::function<void(Character&)>& mutator) override;
+    Character* search(const std::string& name) override;
+    const Character* search(const std::string& name) const override;
+    void displayAll() override;
+
+    void buildFromSorted(std::vector<Character>& sorted) override;
+    bool empty() const override { return records.empty(); }
+    size_t size() const override { return records.size(); }
+    void clear() override;
+
+    bool lookup(const std::string& name, Character& out) const override;
+    bool visit(const std::string& name, const std::function<void(const Character&)>& fn) const override;
+    void forEachInOrder(const std::function<void(const Character&)>& fn) const override;
+    void forEachWithPrefix(const std::string& prefix, const std::function<void(const Character&)>& fn) const override;
+};
+
+#endif
@@ -0,0 +1,153 @@
+// ===========================================================
+// Capstone Project
+// CRUD Functionality - BST - SQLite - Html Report
+// Author: Austin Thompson
+// ------------------------------------------------------
+// Description: Striped hot character cache with count-min
+// admission.
+//-------------------------------------------------------
+// ===========================================================
+
+#include "HotCharacterCache.h"
+#include <functional>
+
+// Capacity is split evenly over the stripes, rounded up to a power
+// of two sets per stripe
+HotCharacterCache::HotCharacterCache(size_t capacity) : stripes(new Stripe[stripeCount]) {
+	size_t sets = 1;
+	while (sets * ways * stripeCount < capacity) sets *= 2;
+	setMask = sets - 1;
+	sketchBits = 8;
+	while ((size_t(1) << sketchBits) < sets * ways * 8) ++sketchBits;
+	sketchWindow = 10u << sketchBits;
+	for (size_t i = 0; i < stripeCount; ++i) {
+		stripes[i].entries.resize(sets * ways);
+		stripes[i].sketch.assign(sketchRows << sketchBits, 0);
+		stripes[i].samples = 0;
+	}
+}
+
+uint64_t HotCharacterCache::hash(const std::string& name) {
+	uint64_t x = static_cast<uint64_t>(std::hash<std::string>()(name));
+	x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+	x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+	return x ^ (x >> 31);
+}
+
+// Top bits pick the stripe and bits from 32 up the set
+HotCharacterCache::Stripe& HotCharacterCache::stripeOf(uint64_t h) const {
+	return stripes[h >> 60];
+}
+
+HotCharacterCache::Entry* HotCharacterCache::setOf(Stripe& stripe, uint64_t h) const {
+	return &stripe.entries[((h >> 32) & setMask) * ways];
+}
+
+// Each row multiplies by its own odd constant and keeps the top bits,
+// so names sharing a stripe or set still spread over the counters
+size_t HotCharacterCache::counter(size_t row, uint64_t h) const {
+	static const uint64_t rowKeys[sketchRows] = {
+		0x9E3779B97F4A7C15ull, 0xC2B2AE3D27D4EB4Full, 0x165667B19E3779F9ull, 0xD6E8FEB86659FD93ull
+	};
+	return (row << sketchBits) + static_cast<size_t>((h * rowKeys[row]) >> (64 - sketchBits));
+}
+
+unsigned HotCharacterCache::frequency(const Stripe& stripe, uint64_t h) const {
+	unsigned least = 255;
+	for (size_t row = 0; row < sketchRows; ++row) {
+		unsigned c = stripe.sketch[counter(row, h)];
+		if (c < least) least = c;
+	}
+	return least;
+}
+
+// Halving every so often lets names that have cooled off be replaced
+void HotCharacterCache::count(Stripe& stripe, uint64_t h) const {
+	for (size_t row = 0; row < sketchRows; ++row) {
+		uint8_t& c = stripe.sketch[counter(row, h)];
+		if (c < 255) ++c;
+	}
+	if (++stripe.samples < sketchWindow) return;
+	for (uint8_t& c : stripe.sketch) c >>= 1;
+	stripe.samples /= 2;
+}
+
+//======================================
+//		Lookups
+//======================================
+Character* HotCharacterCache::find(const std::string& name) {
+	uint64_t h = hash(name);
+	Stripe& stripe = stripeOf(h);
+	std::lock_guard<std::mutex> guard(stripe.lock);
+	count(stripe, h);
+	const Entry* set = setOf(stripe, h);
+	for (size_t way = 0; way < ways; ++way) {
+		const Entry& e = set[way];
+		if (e.record && e.hash == h && e.name == name) {
+			hits.fetch_add(1, std::memory_order_relaxed);
+			return e.record;
+		}
+	}
+	misses.fetch_add(1, std::memory_order_relaxed);
+	return nullptr;
+}
+
+// Takes a free way, or the least requested one if the new name
+// has been asked for more often than it
+void HotCharacterCache::admit(const std::string& name, Character* record) {
+	uint64_t h = hash(name);
+	Stripe& stripe = stripeOf(h);
+	std::lock_guard<std::mutex> guard(stripe.lock);
+	Entry* set = setOf(stripe, h);
+	Entry* victim = nullptr;
+	unsigned victimCount = 0;
+	for (size_t way = 0; way < ways; ++way) {
+		Entry& e = set[way];
+		if (e.record && e.hash == h && e.name == name) {
+			e.record = record;
+			return;
+		}
+	}
+	for (size_t way = 0; way < ways; ++way) {
+		Entry& e = set[way];
+		if (!e.record) {
+			victim = &e;
+			victimCount = 0;
+			break;
+		}
+		unsigned c = frequency(stripe, e.hash);
+		if (!victim || c < victimCount) {
+			victim = &e;
+			victimCount = c;
+		}
+	}
+	if (victim->record && frequency(stripe, h) <= victimCount) return;
+	victim->hash = h;
+	victim->name = name;
+	victim->record = record;
+}
+
+void HotCharacterCache::forget(const std::string& name) {
+	uint64_t h = hash(name);
+	Stripe& stripe = stripeOf(h);
+	std::lock_guard<std::mutex> guard(stripe.lock);
+	Entry* set = setOf(stripe, h);
+	for (size_t way = 0; way < ways; ++way) {
+		if (set[way].record && set[way].hash == h && set[way].name == name) set[way].record = nullptr;
+	}
+}
+
+// Entries only, the request history stays
+void HotCharacterCache::clear() {
+	for (size_t i = 0; i < stripeCount; ++i) {
+		std::lock_guard<std::mutex> guard(stripes[i].lock);
+		for (Entry& e : stripes[i].entries) e.record = nullptr;
+	}
+}
+
+HotCacheStats HotCharacterCache::stats() const {
+	HotCacheStats s;
+	s.hits = hits.load(std::memory_order_relaxed);
+	s.misses = misses.load(std::memory_order_relaxed);
+	return s;
+}
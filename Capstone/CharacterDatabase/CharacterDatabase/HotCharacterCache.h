@@ -0,0 +1,88 @@
+// ===========================================================
+// Capstone Project
+// CRUD Functionality - BST - SQLite - Html Report
+// Author: Austin Thompson
+// ------------------------------------------------------
+// Description: Small cache of the most requested characters,
+// placed in front of the index for skewed lookup traffic.
+// Each stripe keeps small four way sets and a count-min sketch
+// of recent requests, and a new name only takes an entry from
+// one in its set that has been asked for less often.
+//-------------------------------------------------------
+// ===========================================================
+
+#ifndef HOT_CHARACTER_CACHE_H
+#define HOT_CHARACTER_CACHE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+struct Character;
+
+// Counters since the cache was enabled
+struct HotCacheStats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+
+    double hitRatio() const { return hits + misses ? double(hits) / double(hits + misses) : 0.0; }
+};
+
+//==================================
+// Hot Character Cache Class
+// Holds pointers into the index, so
+// the owner forgets a name before its
+// record moves or goes away
+//==================================
+class HotCharacterCache {
+private:
+    static const size_t stripeCount = 16;
+    static const size_t ways = 4;
+    static const size_t sketchRows = 4;
+
+    struct Entry {
+        uint64_t hash = 0;
+        std::string name;
+        Character* record = nullptr;
+    };
+
+    struct Stripe {
+        std::mutex lock;
+        std::vector<Entry> entries;                     //Sets of ways entries
+        std::vector<uint8_t> sketch;                    //sketchRows rows of 2^sketchBits counters
+        uint32_t samples;
+    };
+
+    std::unique_ptr<Stripe[]> stripes;
+    size_t setMask;
+    unsigned sketchBits;                                //Eight counters per entry, at least 256
+    uint32_t sketchWindow;                              //Counts halve after this many requests
+    std::atomic<uint64_t> hits{ 0 };
+    std::atomic<uint64_t> misses{ 0 };
+
+    static uint64_t hash(const std::string& name);
+    Stripe& stripeOf(uint64_t h) const;
+    Entry* setOf(Stripe& stripe, uint64_t h) const;
+    size_t counter(size_t row, uint64_t h) const;
+    unsigned frequency(const Stripe& stripe, uint64_t h) const;
+    void count(Stripe& stripe, uint64_t h) const;
+
+public:
+    explicit HotCharacterCache(size_t capacity = 1024);
+
+    // Counts the request, null when the name is not cached
+    Character* find(const std::string& name);
+
+    // Offers a record found in the index after a miss
+    void admit(const std::string& name, Character* record);
+    void forget(const std::string& name);
+    void clear();
+
+    HotCacheStats stats() const;
+};
+
+#endif
@@ -0,0 +1,55 @@
+// ===========================================================
+// Capstone Project
+// CRUD Functionality - BST - SQLite - Html Report
+// Author: Austin Thompson
+// ------------------------------------------------------
+// Description: Blocked Bloom filter over character names.
+//-------------------------------------------------------
+// ===========================================================
+
+#include "NameFilter.h"
+#include <functional>
+
+// Room for at least 1024 names, block count rounded up
+NameFilter::NameFilter(size_t expected) : entries(0), removed(0) {
+	capacity = expected < 1024 ? 1024 : expected;
+	blocks = (capacity * 10 + 511) / 512;
+	words.assign(blocks * wordsPerBlock, 0);
+}
+
+// std::hash mixed so the high and low halves are independent
+uint64_t NameFilter::hash(const std::string& name) {
+	uint64_t x = static_cast<uint64_t>(std::hash<std::string>()(name));
+	x += 0x9E3779B97F4A7C15ull;
+	x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+	x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+	return x ^ (x >> 31);
+}
+
+// The top 32 bits pick the block, a remix gives six 9 bit positions in it
+static uint64_t positions(uint64_t h) {
+	return (h ^ (h >> 31)) * 0x94D049BB133111EBull;
+}
+
+void NameFilter::add(const std::string& name) {
+	uint64_t h = hash(name);
+	uint64_t* block = &words[((h >> 32) * blocks >> 32) * wordsPerBlock];
+	uint64_t spread = positions(h);
+	for (int i = 0; i < bitsPerName; ++i) {
+		unsigned bit = (spread >> (9 * i)) & 511;
+		block[bit >> 6] |= uint64_t(1) << (bit & 63);
+	}
+	++entries;
+}
+
+bool NameFilter::mayContain(const std::string& name) const {
+	uint64_t h = hash(name);
+	const uint64_t* block = &words[((h >> 32) * blocks >> 32) * wordsPerBlock];
+	uint64_t spread = positions(h);
+	uint64_t missing = 0;
+	for (int i = 0; i < bitsPerName; ++i) {
+		unsigned bit = (spread >> (9 * i)) & 511;
+		missing |= ~block[bit >> 6] & (uint64_t(1) << (bit & 63));
+	}
+	return missing == 0;
+}
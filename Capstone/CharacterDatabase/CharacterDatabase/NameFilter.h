@@ -0,0 +1,53 @@
+// ===========================================================
+// Capstone Project
+// CRUD Functionality - BST - SQLite - Html Report
+// Author: Austin Thompson
+// ------------------------------------------------------
+// Description: Blocked Bloom filter over character names.
+// All bits of one name fall in a single 64 byte block, so a
+// check costs one cache line. No false negatives; about 1%
+// of absent names pass at the planned load.
+//-------------------------------------------------------
+// ===========================================================
+
+#ifndef NAME_FILTER_H
+#define NAME_FILTER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+//==================================
+// Name Filter Class
+// Removed names keep their bits until
+// a rebuild, which needsRebuild asks
+// for after enough removals or once
+// the planned capacity is exceeded
+//==================================
+class NameFilter {
+private:
+    static const size_t wordsPerBlock = 8;              //512 bits, one cache line
+    static const int bitsPerName = 6;
+
+    std::vector<uint64_t> words;
+    size_t blocks;
+    size_t capacity;                                    //Names planned for, 10 bits each
+    size_t entries;                                     //Names added since the last build
+    size_t removed;                                     //Removals since the last build
+
+    static uint64_t hash(const std::string& name);
+
+public:
+    explicit NameFilter(size_t expected = 0);
+
+    void add(const std::string& name);
+    bool mayContain(const std::string& name) const;
+    void noteRemoval() { ++removed; }
+
+    // Past capacity the false positive rate climbs, and after many
+    // removals stale bits let too many misses through
+    bool needsRebuild() const { return entries > capacity || removed > entries / 2 + 64; }
+};
+
+#endif
@@ -0,0 +1,81 @@
+// ===========================================================
+// Capstone Project
+// CRUD Functionality - BST - SQLite - Html Report
+// Author: Austin Thompson
+// ------------------------------------------------------
+// Description: Fixed size object pool. Slots are carved
+// from large chunks and recycled through a free list, so
+// each tree owns its own allocator. Not thread safe, the
+// owner's lock covers it.
+//-------------------------------------------------------
+// ===========================================================
+
+#ifndef OBJECT_POOL_H
+#define OBJECT_POOL_H
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+//==================================
+// Object Pool Class
+//==================================
+template <typename T>
+class ObjectPool {
+private:
+    // Free slots reuse their storage as the list link
+    union Slot {
+        Slot* next;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    std::vector<std::unique_ptr<Slot[]>> chunks;
+    Slot* freeList;
+    size_t nextChunkSize;
+
+    void grow() {
+        std::unique_ptr<Slot[]> chunk(new Slot[nextChunkSize]);
+        for (size_t i = 0; i < nextChunkSize; ++i) {
+            chunk[i].next = freeList;
+            freeList = &chunk[i];
+        }
+        chunks.push_back(std::move(chunk));
+        // Double up to a cap so small trees stay small
+        if (nextChunkSize < 4096) nextChunkSize *= 2;
+    }
+
+public:
+    ObjectPool() : freeList(nullptr), nextChunkSize(16) {}
+
+    ObjectPool(const ObjectPool&) = delete;
+    ObjectPool& operator=(const ObjectPool&) = delete;
+
+    // Constructs an object in a free slot
+    template <typename... Args>
+    T* create(Args&&... args) {
+        if (!freeList) grow();
+        Slot* slot = freeList;
+        freeList = slot->next;
+        try {
+            return new (slot->storage) T(std::forward<Args>(args)...);
+        }
+        catch (...) {
+            slot->next = freeList;
+            freeList = slot;
+            throw;
+        }
+    }
+
+    // Destroys an object and returns its slot to the free list
+    void destroy(T* obj) {
+        if (!obj) return;
+        obj->~T();
+        Slot* slot = reinterpret_cast<Slot*>(obj);
+        slot->next = freeList;
+        freeList = slot;
+    }
+};
+
+#endif
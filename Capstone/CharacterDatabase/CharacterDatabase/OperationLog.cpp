@@ -0,0 +1,412 @@
+// ===========================================================
+// Capstone Project
+// CRUD Functionality - BST - SQLite - Html Report
+// Author: Austin Thompson
+// ------------------------------------------------------
+// Description: Append only, checksummed write ahead log
+// of CRUD operations with group commit and snapshots.
+//-------------------------------------------------------
+// ===========================================================
+
+#include "OperationLog.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+//======================================
+//		Encoding Helpers
+//	Fixed width fields are little endian
+//======================================
+
+// Standard CRC-32 (IEEE), table built on first use
+static uint32_t crc32(const char* data, size_t size) {
+	static const std::vector<uint32_t> table = []() {
+		std::vector<uint32_t> t(256);
+		for (uint32_t i = 0; i < 256; ++i) {
+			uint32_t c = i;
+			for (int k = 0; k < 8; ++k) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+			t[i] = c;
+		}
+		return t;
+		}();
+	uint32_t crc = 0xFFFFFFFFu;
+	for (size_t i = 0; i < size; ++i) {
+		crc = table[(crc ^ static_cast<unsigned char>(data[i])) & 0xFF] ^ (crc >> 8);
+	}
+	return crc ^ 0xFFFFFFFFu;
+}
+
+// Appends a 4 byte value
+template <typename T>
+static void put4(std::vector<char>& out, T value) {
+	static_assert(sizeof(T) == 4, "put4 writes 4 byte fields");
+	char bytes[4];
+	std::memcpy(bytes, &value, 4);
+	out.insert(out.end(), bytes, bytes + 4);
+}
+
+// Appends a length prefixed string
+static void putString(std::vector<char>& out, const std::string& s) {
+	put4(out, static_cast<uint32_t>(s.size()));
+	out.insert(out.end(), s.begin(), s.end());
+}
+
+// Reads from a payload, throws when it runs past the end
+struct Reader {
+	const char* pos;
+	const char* end;
+
+	template <typename T>
+	T get4() {
+		if (end - pos < 4) throw std::runtime_error("Log record truncated");
+		T value;
+		std::memcpy(&value, pos, 4);
+		pos += 4;
+		return value;
+	}
+
+	std::string getString() {
+		uint32_t size = get4<uint32_t>();
+		if (static_cast<size_t>(end - pos) < size) throw std::runtime_error("Log record truncated");
+		std::string s(pos, size);
+		pos += size;
+		return s;
+	}
+};
+
+static void putCharacter(std::vector<char>& out, const Character& c) {
+	putString(out, c.name);
+	putString(out, c.ability1);
+	putString(out, c.ability2);
+	putString(out, c.ability3);
+	putString(out, c.ability4);
+	put4(out, static_cast<int32_t>(c.gunDPS));
+	put4(out, c.bulletDMG);
+	put4(out, static_cast<int32_t>(c.ammo));
+	put4(out, c.bulletSpeed);
+	put4(out, static_cast<int32_t>(c.lightMeleeDMG));
+	put4(out, static_cast<int32_t>(c.heavyMeleeDMG));
+	put4(out, static_cast<int32_t>(c.health));
+	put4(out, c.regen);
+	put4(out, c.bulletResist);
+	put4(out, c.spiritResist);
+	put4(out, c.speed);
+	put4(out, c.sprint);
+	put4(out, static_cast<int32_t>(c.stamina));
+}
+
+static Character getCharacter(Reader& in) {
+	Character c;
+	c.name = in.getString();
+	c.ability1 = in.getString();
+	c.ability2 = in.getString();
+	c.ability3 = in.getString();
+	c.ability4 = in.getString();
+	c.gunDPS = in.get4<int32_t>();
+	c.bulletDMG = in.get4<float>();
+	c.ammo = in.get4<int32_t>();
+	c.bulletSpeed = in.get4<float>();
+	c.lightMeleeDMG = in.get4<int32_t>();
+	c.heavyMeleeDMG = in.get4<int32_t>();
+	c.health = in.get4<int32_t>();
+	c.regen = in.get4<float>();
+	c.bulletResist = in.get4<float>();
+	c.spiritResist = in.get4<float>();
+	c.speed = in.get4<float>();
+	c.sprint = in.get4<float>();
+	c.stamina = in.get4<int32_t>();
+	return c;
+}
+
+// Patch body: the field mask, then each masked field in Character order
+static void putFields(std::vector<char>& out, const Character& c, uint32_t fields) {
+	put4(out, fields);
+	if (fields & CharacterField::Ability1) putString(out, c.ability1);
+	if (fields & CharacterField::Ability2) putString(out, c.ability2);
+	if (fields & CharacterField::Ability3) putString(out, c.ability3);
+	if (fields & CharacterField::Ability4) putString(out, c.ability4);
+	if (fields & CharacterField::GunDPS) put4(out, static_cast<int32_t>(c.gunDPS));
+	if (fields & CharacterField::BulletDMG) put4(out, c.bulletDMG);
+	if (fields & CharacterField::Ammo) put4(out, static_cast<int32_t>(c.ammo));
+	if (fields & CharacterField::BulletSpeed) put4(out, c.bulletSpeed);
+	if (fields & CharacterField::LightMeleeDMG) put4(out, static_cast<int32_t>(c.lightMeleeDMG));
+	if (fields & CharacterField::HeavyMeleeDMG) put4(out, static_cast<int32_t>(c.heavyMeleeDMG));
+	if (fields & CharacterField::Health) put4(out, static_cast<int32_t>(c.health));
+	if (fields & CharacterField::Regen) put4(out, c.regen);
+	if (fields & CharacterField::BulletResist) put4(out, c.bulletResist);
+	if (fields & CharacterField::SpiritResist) put4(out, c.spiritResist);
+	if (fields & CharacterField::Speed) put4(out, c.speed);
+	if (fields & CharacterField::Sprint) put4(out, c.sprint);
+	if (fields & CharacterField::Stamina) put4(out, static_cast<int32_t>(c.stamina));
+}
+
+static uint32_t getFields(Reader& in, Character& c) {
+	uint32_t fields = in.get4<uint32_t>();
+	if (fields & ~static_cast<uint32_t>(CharacterField::All)) throw std::runtime_error("Bad patch fields");
+	if (fields & CharacterField::Ability1) c.ability1 = in.getString();
+	if (fields & CharacterField::Ability2) c.ability2 = in.getString();
+	if (fields & CharacterField::Ability3) c.ability3 = in.getString();
+	if (fields & CharacterField::Ability4) c.ability4 = in.getString();
+	if (fields & CharacterField::GunDPS) c.gunDPS = in.get4<int32_t>();
+	if (fields & CharacterField::BulletDMG) c.bulletDMG = in.get4<float>();
+	if (fields & CharacterField::Ammo) c.ammo = in.get4<int32_t>();
+	if (fields & CharacterField::BulletSpeed) c.bulletSpeed = in.get4<float>();
+	if (fields & CharacterField::LightMeleeDMG) c.lightMeleeDMG = in.get4<int32_t>();
+	if (fields & CharacterField::HeavyMeleeDMG) c.heavyMeleeDMG = in.get4<int32_t>();
+	if (fields & CharacterField::Health) c.health = in.get4<int32_t>();
+	if (fields & CharacterField::Regen) c.regen = in.get4<float>();
+	if (fields & CharacterField::BulletResist) c.bulletResist = in.get4<float>();
+	if (fields & CharacterField::SpiritResist) c.spiritResist = in.get4<float>();
+	if (fields & CharacterField::Speed) c.speed = in.get4<float>();
+	if (fields & CharacterField::Sprint) c.sprint = in.get4<float>();
+	if (fields & CharacterField::Stamina) c.stamina = in.get4<int32_t>();
+	return fields;
+}
+
+// Builds one frame: header, then count and records
+static void appendFrame(std::vector<char>& out, const std::vector<LogRecord>& records, size_t first, size_t last) {
+	std::vector<char> payload;
+	put4(payload, static_cast<uint32_t>(last - first));
+	for (size_t i = first; i < last; ++i) {
+		const LogRecord& r = records[i];
+		payload.push_back(static_cast<char>(r.op));
+		putString(payload, r.name);
+		if (r.op == LogRecord::Patch) putFields(payload, r.record, r.fields);
+		else if (r.op != LogRecord::Delete) putCharacter(payload, r.record);
+	}
+	put4(out, static_cast<uint32_t>(payload.size()));
+	put4(out, crc32(payload.data(), payload.size()));
+	out.insert(out.end(), payload.begin(), payload.end());
+}
+
+// Flushes stdio buffers and forces the file to disk
+static void syncFile(FILE* file) {
+	if (std::fflush(file) != 0) throw std::runtime_error("Operation log flush failed");
+#ifdef _WIN32
+	if (_commit(_fileno(file)) != 0) throw std::runtime_error("Operation log sync failed");
+#else
+	if (fsync(fileno(file)) != 0) throw std::runtime_error("Operation log sync failed");
+#endif
+}
+
+// Makes a rename inside dir durable. Windows has no directory handle
+// to sync, NTFS journals the rename itself.
+static void syncDirectory(const std::filesystem::path& dir) {
+#ifndef _WIN32
+	int fd = open(dir.empty() ? "." : dir.c_str(), O_RDONLY);
+	if (fd < 0) throw std::runtime_error("Cannot open directory to sync: " + dir.string());
+	int result = fsync(fd);
+	close(fd);
+	if (result != 0) throw std::runtime_error("Directory sync failed: " + dir.string());
+#else
+	(void)dir;
+#endif
+}
+
+//======================================
+//		Operation Log
+//======================================
+OperationLog::OperationLog(const std::string& logFile)
+	: path(logFile), file(nullptr), enqueuedSeq(0), durableSeq(0), flushing(false), failed(false),
+	durableOffset(0), recordsSinceReset(0) {
+	file = std::fopen(path.c_str(), "ab");
+	if (!file) throw std::runtime_error("Cannot open operation log: " + path);
+	std::error_code ec;
+	durableOffset = std::filesystem::file_size(path, ec);
+	if (ec) throw std::runtime_error("Cannot open operation log: " + path);
+}
+
+OperationLog::~OperationLog() {
+	if (file) std::fclose(file);
+}
+
+uint64_t OperationLog::enqueue(const std::vector<LogRecord>& records) {
+	std::lock_guard<std::mutex> lock(mtx);
+	if (failed) throw std::runtime_error("Operation log failed: an earlier write was lost, checkpoint to recover");
+	appendFrame(pending, records, 0, records.size());
+	recordsSinceReset += records.size();
+	return ++enqueuedSeq;
+}
+
+// Writes outside the lock so new frames can queue meanwhile
+void OperationLog::flushAndSync(const std::vector<char>& bytes) {
+	if (!file) throw std::runtime_error("Operation log is not open");
+	if (!bytes.empty() && std::fwrite(bytes.data(), 1, bytes.size(), file) != bytes.size()) {
+		throw std::runtime_error("Operation log write failed");
+	}
+	syncFile(file);
+}
+
+void OperationLog::waitDurable(uint64_t seq) {
+	std::unique_lock<std::mutex> lock(mtx);
+	while (durableSeq < seq) {
+		if (failed) throw std::runtime_error("Operation log write failed");
+		if (flushing) {
+			// Another writer is leading, its fsync may cover us
+			flushed.wait(lock);
+			continue;
+		}
+
+		// Become the leader for everything queued so far
+		flushing = true;
+		std::vector<char> bytes;
+		bytes.swap(pending);
+		uint64_t batchSeq = enqueuedSeq;
+		lock.unlock();
+		try {
+			flushAndSync(bytes);
+		}
+		catch (...) {
+			// The batch is gone and may be half written. Nothing past
+			// durableSeq can be acknowledged, so the log stops here.
+			lock.lock();
+			failed = true;
+			pending.clear();
+			truncateToDurable();
+			flushing = false;
+			flushed.notify_all();
+			throw;
+		}
+		lock.lock();
+		flushing = false;
+		durableSeq = batchSeq;
+		durableOffset += bytes.size();
+		flushed.notify_all();
+	}
+}
+
+// Cuts a torn frame off the end so a reset or replay starts clean.
+// Best effort, the log is already failed if this fails too.
+void OperationLog::truncateToDurable() {
+	if (file) std::fclose(file);
+	std::error_code ec;
+	std::filesystem::resize_file(path, durableOffset, ec);
+	file = std::fopen(path.c_str(), "ab");
+}
+
+// Reopens the file truncated. Queued frames are dropped because the
+// caller's checkpoint already holds their changes, waiters are released.
+void OperationLog::reset() {
+	std::unique_lock<std::mutex> lock(mtx);
+	while (flushing) flushed.wait(lock);
+	if (file) std::fclose(file);
+	file = std::fopen(path.c_str(), "wb");
+	if (!file) throw std::runtime_error("Cannot reset operation log: " + path);
+	pending.clear();
+	durableSeq = enqueuedSeq;
+	durableOffset = 0;
+	failed = false;
+	recordsSinceReset = 0;
+	flushed.notify_all();
+}
+
+size_t OperationLog::recordCount() {
+	std::lock_guard<std::mutex> lock(mtx);
+	return recordsSinceReset;
+}
+
+void OperationLog::replay(const std::string& logFile, const std::function<void(const LogRecord&)>& apply) {
+	readFrames(logFile, apply, false);
+}
+
+bool OperationLog::readSnapshot(const std::string& snapshotFile, const std::function<void(const LogRecord&)>& apply) {
+	return readFrames(snapshotFile, apply, true);
+}
+
+// Stops at the first frame that is short, fails its checksum or does
+// not decode. A log is cut back there; a snapshot was published whole
+// by rename, so there it is corruption and the file is left alone.
+bool OperationLog::readFrames(const std::string& logFile, const std::function<void(const LogRecord&)>& apply, bool strict) {
+	FILE* in = std::fopen(logFile.c_str(), "rb");
+	if (!in) return false;
+
+	std::error_code ec;
+	uintmax_t fileSize = std::filesystem::file_size(logFile, ec);
+	long goodEnd = 0;
+	std::vector<char> payload;
+	while (true) {
+		uint32_t header[2];
+		if (std::fread(header, sizeof(uint32_t), 2, in) != 2) break;
+		// A corrupt size must not trigger a huge allocation
+		if (header[0] > fileSize - static_cast<uintmax_t>(std::ftell(in))) break;
+		payload.resize(header[0]);
+		if (std::fread(payload.data(), 1, payload.size(), in) != payload.size()) break;
+		if (crc32(payload.data(), payload.size()) != header[1]) break;
+
+		// Decode the whole frame before applying any of it
+		std::vector<LogRecord> records;
+		try {
+			Reader r = { payload.data(), payload.data() + payload.size() };
+			uint32_t count = r.get4<uint32_t>();
+			for (uint32_t i = 0; i < count; ++i) {
+				LogRecord rec;
+				unsigned char op = r.pos < r.end ? static_cast<unsigned char>(*r.pos++) : 0;
+				if (op < LogRecord::Add || op > LogRecord::Patch) throw std::runtime_error("Bad log op");
+				rec.op = static_cast<LogRecord::Op>(op);
+				rec.name = r.getString();
+				if (rec.op == LogRecord::Patch) rec.fields = getFields(r, rec.record);
+				else if (rec.op != LogRecord::Delete) rec.record = getCharacter(r);
+				records.push_back(std::move(rec));
+			}
+		}
+		catch (std::exception&) {
+			break;
+		}
+		for (const LogRecord& rec : records) apply(rec);
+		goodEnd = std::ftell(in);
+	}
+
+	std::fclose(in);
+
+	if (fileSize > static_cast<uintmax_t>(goodEnd)) {
+		if (strict) throw std::runtime_error("Snapshot corrupt: bad frame in " + logFile);
+		// Drop the torn tail left by a crash mid write
+		std::filesystem::resize_file(logFile, static_cast<uintmax_t>(goodEnd), ec);
+		if (ec) throw std::runtime_error("Cannot truncate operation log: " + logFile);
+	}
+	return true;
+}
+
+void OperationLog::writeSnapshot(const std::string& snapshotFile, const std::vector<Character>& characters) {
+	const size_t recordsPerFrame = 1024;
+	std::string tmpFile = snapshotFile + ".tmp";
+	FILE* out = std::fopen(tmpFile.c_str(), "wb");
+	if (!out) throw std::runtime_error("Cannot write snapshot: " + tmpFile);
+
+	std::vector<LogRecord> records;
+	std::vector<char> bytes;
+	for (size_t first = 0; first < characters.size(); first += recordsPerFrame) {
+		size_t last = std::min(characters.size(), first + recordsPerFrame);
+		records.clear();
+		for (size_t i = first; i < last; ++i) records.push_back({ LogRecord::Add, characters[i].name, characters[i] });
+		bytes.clear();
+		appendFrame(bytes, records, 0, records.size());
+		if (std::fwrite(bytes.data(), 1, bytes.size(), out) != bytes.size()) {
+			std::fclose(out);
+			throw std::runtime_error("Snapshot write failed: " + tmpFile);
+		}
+	}
+	try {
+		syncFile(out);
+	}
+	catch (...) {
+		std::fclose(out);
+		throw;
+	}
+	std::fclose(out);
+
+	// Replace the old snapshot in one step
+	std::error_code ec;
+	std::filesystem::rename(tmpFile, snapshotFile, ec);
+	if (ec) throw std::runtime_error("Cannot replace snapshot: " + snapshotFile);
+	// The caller truncates the log next, the new name must be on disk first
+	syncDirectory(std::filesystem::path(snapshotFile).parent_path());
+}
@@ -0,0 +1,106 @@
+// ===========================================================
+// Capstone Project
+// CRUD Functionality - BST - SQLite - Html Report
+// Author: Austin Thompson
+// ------------------------------------------------------
+// Description: Append only, checksummed write ahead log
+// of CRUD operations. Concurrent writers are grouped into
+// a single flush + fsync. Snapshots written at checkpoints
+// use the same record format.
+//-------------------------------------------------------
+// ===========================================================
+
+#ifndef OPERATION_LOG_H
+#define OPERATION_LOG_H
+
+#include "Character.h"
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+//==================================
+// Log Record
+// One CRUD operation, Add and Update
+// carry the full record after the change,
+// Patch only the fields it changed
+//==================================
+struct LogRecord {
+    enum Op : uint8_t { Add = 1, Update = 2, Delete = 3, Patch = 4 };
+
+    Op op;
+    std::string name;       // Key the operation applies to
+    Character record;       // Unused for Delete
+    uint32_t fields = 0;    // CharacterField bits set in record, Patch only
+};
+
+//==================================
+// Operation Log Class
+// File layout is a list of frames:
+//   [u32 payload size][u32 crc32][payload]
+// A payload holds one or more records and is
+// replayed all or nothing, so a transaction
+// written as one frame is atomic on disk
+//==================================
+class OperationLog {
+private:
+    std::string path;
+    FILE* file;
+
+    // Group commit state, guarded by mtx
+    std::mutex mtx;
+    std::condition_variable flushed;
+    std::vector<char> pending;      // Frames waiting for the next flush
+    uint64_t enqueuedSeq;           // Last frame handed to the log
+    uint64_t durableSeq;            // Last frame known to be on disk
+    bool flushing;                  // A leader is writing right now
+    bool failed;                    // A flush failed, set until reset
+    uint64_t durableOffset;         // File size as of durableSeq
+    size_t recordsSinceReset;
+
+    void flushAndSync(const std::vector<char>& bytes);
+    void truncateToDurable();
+    static bool readFrames(const std::string& logFile, const std::function<void(const LogRecord&)>& apply, bool strict);
+
+public:
+    // Opens (or creates) the log for appending
+    explicit OperationLog(const std::string& logFile);
+    ~OperationLog();
+
+    OperationLog(const OperationLog&) = delete;
+    OperationLog& operator=(const OperationLog&) = delete;
+
+    // Queues the records as one frame and returns its sequence number.
+    // Call under the same lock that ordered the in memory change.
+    uint64_t enqueue(const std::vector<LogRecord>& records);
+
+    // Blocks until the frame is durable. The first waiter flushes
+    // every queued frame with one fsync, the rest ride along.
+    // If a flush fails the file is cut back to its last durable
+    // frame and the log stays failed: every frame not yet durable
+    // throws, and enqueue throws, until reset.
+    void waitDurable(uint64_t seq);
+
+    // Empties the log after a checkpoint captured its contents,
+    // which also clears a failed flush
+    void reset();
+
+    size_t recordCount();
+
+    // Replays every intact frame in order. A torn or corrupt tail is
+    // cut off so later appends start from the last good frame.
+    static void replay(const std::string& logFile, const std::function<void(const LogRecord&)>& apply);
+
+    // Reads a snapshot written by writeSnapshot. Any bad frame throws
+    // and the file is never changed. False if there is no snapshot.
+    static bool readSnapshot(const std::string& snapshotFile, const std::function<void(const LogRecord&)>& apply);
+
+    // Writes records as a standalone file, synced and atomically
+    // renamed, with the directory synced so the rename survives a crash
+    static void writeSnapshot(const std::string& snapshotFile, const std::vector<Character>& characters);
+};
+
+#endif
@@ -0,0 +1,138 @@
+// ===========================================================
+// Capstone Project
+// CRUD Functionality - BST - SQLite - Html Report
+// Author: Austin Thompson
+// ------------------------------------------------------
+// Description: CHD style minimal perfect hash over names.
+//-------------------------------------------------------
+// ===========================================================
+
+#include "PerfectNameHash.h"
+#include <cstring>
+#include <stdexcept>
+
+static const uint32_t maxPilot = 1u << 24;
+static const int maxSeeds = 8;
+
+static uint64_t mix(uint64_t x) {
+	x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+	x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+	return x ^ (x >> 31);
+}
+
+// Eight bytes of the name per round, the length goes into the start
+uint64_t PerfectNameHash::hash(const std::string& name, uint64_t seed) {
+	const char* bytes = name.data();
+	size_t left = name.size();
+	uint64_t h = mix(seed ^ (left * 0x9E3779B97F4A7C15ull));
+	for (; left >= 8; left -= 8, bytes += 8) {
+		uint64_t word;
+		std::memcpy(&word, bytes, 8);
+		h = mix(h ^ word);
+	}
+	uint64_t tail = 0;
+	std::memcpy(&tail, bytes, left);
+	return mix(h ^ tail);
+}
+
+// Top 32 bits of the remixed hash scaled onto the slot range
+uint32_t PerfectNameHash::place(uint64_t h, uint32_t pilot, uint32_t slots) {
+	uint64_t x = mix(h + pilot * 0x9E3779B97F4A7C15ull);
+	return static_cast<uint32_t>(((x >> 32) * slots) >> 32);
+}
+
+uint32_t PerfectNameHash::slot(const std::string& name) const {
+	if (slots == 0) return 0;
+	uint64_t h = hash(name, seed);
+	int32_t pilot = pilots[((h >> 32) * pilots.size()) >> 32];
+	if (pilot < 0) return static_cast<uint32_t>(-(pilot + 1));
+	return place(h, static_cast<uint32_t>(pilot), slots);
+}
+
+//======================================
+//		Build
+//======================================
+
+// A fresh seed is only needed if some bucket runs out of pilots,
+// which takes two names with the same 64 bit hash
+void PerfectNameHash::build(size_t count, const std::function<const std::string&(size_t)>& nameAt) {
+	if (count >= (1u << 31)) {
+		throw std::runtime_error("Build failed: too many names for a perfect hash.");
+	}
+	clear();
+	slots = static_cast<uint32_t>(count);
+	std::vector<uint64_t> hashes(count);
+	for (int attempt = 0; attempt < maxSeeds; ++attempt) {
+		seed = mix(attempt + 1);
+		for (size_t i = 0; i < count; ++i) hashes[i] = hash(nameAt(i), seed);
+		if (tryBuild(hashes)) return;
+	}
+	clear();
+	throw std::runtime_error("Build failed: no perfect hash found, names may repeat.");
+}
+
+// Buckets are placed largest first while the table is still empty.
+// Lone names go last, straight into whatever slots remain.
+bool PerfectNameHash::tryBuild(const std::vector<uint64_t>& hashes) {
+	const size_t bucketCount = (hashes.size() + namesPerBucket - 1) / namesPerBucket;
+	pilots.assign(bucketCount ? bucketCount : 1, 0);
+	if (hashes.empty()) return true;
+
+	// Counting sort of the names by bucket
+	std::vector<uint32_t> start(bucketCount + 1, 0);
+	std::vector<uint32_t> bucketOf(hashes.size());
+	for (size_t i = 0; i < hashes.size(); ++i) {
+		bucketOf[i] = static_cast<uint32_t>(((hashes[i] >> 32) * bucketCount) >> 32);
+		++start[bucketOf[i] + 1];
+	}
+	size_t largest = 0;
+	for (size_t b = 0; b < bucketCount; ++b) {
+		if (start[b + 1] > largest) largest = start[b + 1];
+		start[b + 1] += start[b];
+	}
+	std::vector<uint64_t> members(hashes.size());
+	std::vector<uint32_t> fill(start.begin(), start.end() - 1);
+	for (size_t i = 0; i < hashes.size(); ++i) members[fill[bucketOf[i]]++] = hashes[i];
+
+	// Then the buckets by size, largest first
+	std::vector<std::vector<uint32_t>> bySize(largest + 1);
+	for (size_t b = 0; b < bucketCount; ++b) bySize[start[b + 1] - start[b]].push_back(static_cast<uint32_t>(b));
+
+	std::vector<char> taken(slots, 0);
+	std::vector<uint32_t> placed(largest);
+	for (size_t size = largest; size >= 2; --size) {
+		for (uint32_t b : bySize[size]) {
+			const uint64_t* names = &members[start[b]];
+			uint32_t pilot = 0;
+			for (; pilot < maxPilot; ++pilot) {
+				size_t k = 0;
+				for (; k < size; ++k) {
+					uint32_t s = place(names[k], pilot, slots);
+					if (taken[s]) break;
+					size_t j = 0;
+					while (j < k && placed[j] != s) ++j;
+					if (j < k) break;
+					placed[k] = s;
+				}
+				if (k == size) break;
+			}
+			if (pilot == maxPilot) return false;
+			for (size_t k = 0; k < size; ++k) taken[placed[k]] = 1;
+			pilots[b] = static_cast<int32_t>(pilot);
+		}
+	}
+
+	uint32_t next = 0;
+	for (uint32_t b : bySize[1]) {
+		while (taken[next]) ++next;
+		taken[next] = 1;
+		pilots[b] = -static_cast<int32_t>(next) - 1;
+	}
+	return true;
+}
+
+void PerfectNameHash::clear() {
+	pilots.clear();
+	seed = 0;
+	slots = 0;
+}
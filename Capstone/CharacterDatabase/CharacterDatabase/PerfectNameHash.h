@@ -0,0 +1,53 @@
+// ===========================================================
+// Capstone Project
+// CRUD Functionality - BST - SQLite - Html Report
+// Author: Austin Thompson
+// ------------------------------------------------------
+// Description: Minimal perfect hash over a fixed set of
+// character names, built hash and displace (CHD) style.
+// Names are split into buckets of about four, and each bucket
+// stores one pilot that sends all of its names to free slots,
+// so n names map onto slots 0..n-1 with no collisions.
+//-------------------------------------------------------
+// ===========================================================
+
+#ifndef PERFECT_NAME_HASH_H
+#define PERFECT_NAME_HASH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+//==================================
+// Perfect Name Hash Class
+// Names outside the built set still
+// land on some slot, so callers check
+// the record they find there
+//==================================
+class PerfectNameHash {
+private:
+    static const size_t namesPerBucket = 4;             //32 bit pilot each, 8 bits per name
+
+    std::vector<int32_t> pilots;                        //Seed tried, or -(slot + 1) for a lone name
+    uint64_t seed;
+    uint32_t slots;
+
+    static uint64_t hash(const std::string& name, uint64_t seed);
+    static uint32_t place(uint64_t h, uint32_t pilot, uint32_t slots);
+    bool tryBuild(const std::vector<uint64_t>& hashes);
+
+public:
+    PerfectNameHash() : seed(0), slots(0) {}
+
+    // Names must be distinct, nameAt(i) for i below count
+    void build(size_t count, const std::function<const std::string&(size_t)>& nameAt);
+    void clear();
+
+    // Slot of a built name, O(1) with no probing
+    uint32_t slot(const std::string& name) const;
+    size_t size() const { return slots; }
+};
+
+#endif
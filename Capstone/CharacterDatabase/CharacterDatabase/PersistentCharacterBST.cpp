@@ -0,0 +1,291 @@
+// ===========================================================
+// Capstone Project
+// CRUD Functionality - BST - SQLite - Html Report
+// Author: Austin Thompson
+// ------------------------------------------------------
+// Description: Immutable, path copying Binary Search Tree.
+//-------------------------------------------------------
+// ===========================================================
+
+#include "PersistentCharacterBST.h"
+#include <cassert>
+#include <stdexcept>
+#include <unordered_set>
+
+//======================================
+//		Node Helpers
+//======================================
+
+// Priority for a name, mixed so similar names spread out
+static uint64_t namePriority(const std::string& name) {
+	uint64_t x = static_cast<uint64_t>(std::hash<std::string>()(name));
+	x += 0x9E3779B97F4A7C15ull;
+	x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+	x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+	return x ^ (x >> 31);
+}
+
+// Heap order, ties broken by name so the shape stays unique
+static bool above(const PersistentNode* a, const PersistentNode* b) {
+	if (a->priority != b->priority) return a->priority > b->priority;
+	return a->record->name < b->record->name;
+}
+
+// New node sharing the record and children it is given
+static PersistentNodePtr makeNode(std::shared_ptr<const Character> record, PersistentNodePtr left, PersistentNodePtr right, uint64_t priority) {
+	return std::make_shared<const PersistentNode>(std::move(record), std::move(left), std::move(right), priority);
+}
+
+// Copy of a node with new children
+static PersistentNodePtr withChildren(const PersistentNodePtr& node, PersistentNodePtr left, PersistentNodePtr right) {
+	return makeNode(node->record, std::move(left), std::move(right), node->priority);
+}
+
+static bool sameCharacter(const Character& a, const Character& b) {
+	return a.name == b.name && a.ability1 == b.ability1 && a.ability2 == b.ability2 &&
+		a.ability3 == b.ability3 && a.ability4 == b.ability4 && a.gunDPS == b.gunDPS &&
+		a.bulletDMG == b.bulletDMG && a.ammo == b.ammo && a.bulletSpeed == b.bulletSpeed &&
+		a.lightMeleeDMG == b.lightMeleeDMG && a.heavyMeleeDMG == b.heavyMeleeDMG &&
+		a.health == b.health && a.regen == b.regen && a.bulletResist == b.bulletResist &&
+		a.spiritResist == b.spiritResist && a.speed == b.speed && a.sprint == b.sprint &&
+		a.stamina == b.stamina;
+}
+
+//======================================
+//		Path Copying Helpers
+//======================================
+
+// Builds the subtree rooted at index i of the Cartesian tree
+static PersistentNodePtr buildNode(const std::vector<Character>& sorted, const std::vector<uint64_t>& priority,
+	const std::vector<size_t>& left, const std::vector<size_t>& right, size_t i) {
+	if (i == SIZE_MAX) return nullptr;
+	return makeNode(std::make_shared<const Character>(sorted[i]),
+		buildNode(sorted, priority, left, right, left[i]),
+		buildNode(sorted, priority, left, right, right[i]), priority[i]);
+}
+
+static PersistentNodePtr insertPath(const PersistentNodePtr& node, const PersistentNodePtr& leaf) {
+	//Empty Spot Create node
+	if (!node) return leaf;
+	const std::string& name = leaf->record->name;
+	//Go left if smaller, rotate right if the new child outranks us
+	if (name < node->record->name) {
+		PersistentNodePtr left = insertPath(node->left, leaf);
+		if (above(left.get(), node.get())) {
+			return withChildren(left, left->left, withChildren(node, left->right, node->right));
+		}
+		return withChildren(node, left, node->right);
+	}
+	// Go right if larger, rotate left if the new child outranks us
+	if (name > node->record->name) {
+		PersistentNodePtr right = insertPath(node->right, leaf);
+		if (above(right.get(), node.get())) {
+			return withChildren(right, withChildren(node, node->left, right->left), right->right);
+		}
+		return withChildren(node, node->left, right);
+	}
+	// Catch duplicate names
+	throw std::runtime_error("Insert failed: Character with name '" + name + "' already exists.");
+}
+
+static PersistentNodePtr updatePath(const PersistentNodePtr& node, const std::string& name, const std::shared_ptr<const Character>& c) {
+	if (!node) throw std::runtime_error("Update failed: Character '" + name + "' not found.");
+	if (name < node->record->name) return withChildren(node, updatePath(node->left, name, c), node->right);
+	if (name > node->record->name) return withChildren(node, node->left, updatePath(node->right, name, c));
+	// The record keeps this node's place, so it must keep its key
+	assert(c->name == name);
+	return makeNode(c, node->left, node->right, node->priority);
+}
+
+// Joins two treaps where every key of a is below every key of b
+static PersistentNodePtr merge(const PersistentNodePtr& a, const PersistentNodePtr& b) {
+	if (!a) return b;
+	if (!b) return a;
+	if (above(a.get(), b.get())) return withChildren(a, a->left, merge(a->right, b));
+	return withChildren(b, merge(a, b->left), b->right);
+}
+
+static PersistentNodePtr removePath(const PersistentNodePtr& node, const std::string& name) {
+	if (!node) throw std::runtime_error("Delete failed: Character '" + name + "' not found.");
+	if (name < node->record->name) return withChildren(node, removePath(node->left, name), node->right);
+	if (name > node->record->name) return withChildren(node, node->left, removePath(node->right, name));
+	// Node found: its children take its place
+	return merge(node->left, node->right);
+}
+
+// Splits around a name: keys below, the matching record (if any), keys above.
+// Only the search path is copied, hanging subtrees stay shared.
+static void split(const PersistentNodePtr& node, const std::string& name,
+	PersistentNodePtr& below, const PersistentNode*& match, PersistentNodePtr& over) {
+	if (!node) {
+		below = over = nullptr;
+		match = nullptr;
+		return;
+	}
+	if (name < node->record->name) {
+		PersistentNodePtr innerOver;
+		split(node->left, name, below, match, innerOver);
+		over = withChildren(node, innerOver, node->right);
+	}
+	else if (name > node->record->name) {
+		PersistentNodePtr innerBelow;
+		split(node->right, name, innerBelow, match, over);
+		below = withChildren(node, node->left, innerBelow);
+	}
+	else {
+		below = node->left;
+		match = node.get();
+		over = node->right;
+	}
+}
+
+static void inorder(const PersistentNode* node, const std::function<void(const Character&)>& fn) {
+	if (!node) return;
+	inorder(node->left.get(), fn);
+	fn(*node->record);
+	inorder(node->right.get(), fn);
+}
+
+// Compares two subtrees holding the same key range
+static void diffNodes(const PersistentNodePtr& a, const PersistentNodePtr& b,
+	const std::function<void(const CharacterChange&)>& fn) {
+	// Shared subtree, nothing changed below here
+	if (a == b) return;
+	if (!a) {
+		inorder(b.get(), [&](const Character& c) { fn({ CharacterChange::Added, nullptr, &c }); });
+		return;
+	}
+	if (!b) {
+		inorder(a.get(), [&](const Character& c) { fn({ CharacterChange::Removed, &c, nullptr }); });
+		return;
+	}
+
+	// Line b up with a's key, same shape makes this a no copy case
+	PersistentNodePtr below, over;
+	const PersistentNode* match;
+	if (a->record->name == b->record->name) {
+		below = b->left;
+		match = b.get();
+		over = b->right;
+	}
+	else {
+		split(b, a->record->name, below, match, over);
+	}
+
+	diffNodes(a->left, below, fn);
+	if (!match) {
+		fn({ CharacterChange::Removed, a->record.get(), nullptr });
+	}
+	else if (a->record != match->record && !sameCharacter(*a->record, *match->record)) {
+		fn({ CharacterChange::Changed, a->record.get(), match->record.get() });
+	}
+	diffNodes(a->right, over, fn);
+}
+
+static void collectNodes(const PersistentNode* node, std::unordered_set<const PersistentNode*>& seen) {
+	// A node already seen means its whole subtree was seen too
+	if (!node || !seen.insert(node).second) return;
+	collectNodes(node->left.get(), seen);
+	collectNodes(node->right.get(), seen);
+}
+
+//======================================
+//		Public Functions
+//======================================
+
+// Cartesian tree over the sorted records in one stack pass
+PersistentCharacterBST PersistentCharacterBST::fromSorted(const std::vector<Character>& sorted) {
+	size_t n = sorted.size();
+	std::vector<uint64_t> priority(n);
+	std::vector<size_t> left(n, SIZE_MAX), right(n, SIZE_MAX), stack;
+	for (size_t i = 0; i < n; ++i) {
+		priority[i] = namePriority(sorted[i].name);
+		size_t last = SIZE_MAX;
+		while (!stack.empty()) {
+			size_t top = stack.back();
+			bool topAbove = priority[top] != priority[i] ? priority[top] > priority[i] : sorted[top].name < sorted[i].name;
+			if (topAbove) break;
+			last = top;
+			stack.pop_back();
+		}
+		left[i] = last;
+		if (!stack.empty()) right[stack.back()] = i;
+		stack.push_back(i);
+	}
+	PersistentNodePtr root = stack.empty() ? nullptr : buildNode(sorted, priority, left, right, stack.front());
+	return PersistentCharacterBST(root, n);
+}
+
+PersistentCharacterBST PersistentCharacterBST::inserted(const Character& c) const {
+	PersistentNodePtr leaf = makeNode(std::make_shared<const Character>(c), nullptr, nullptr, namePriority(c.name));
+	return PersistentCharacterBST(insertPath(root, leaf), count + 1);
+}
+
+PersistentCharacterBST PersistentCharacterBST::updated(const std::string& name, const Character& c) const {
+	return PersistentCharacterBST(updatePath(root, name, std::make_shared<const Character>(c)), count);
+}
+
+PersistentCharacterBST PersistentCharacterBST::removed(const std::string& name) const {
+	return PersistentCharacterBST(removePath(root, name), count - 1);
+}
+
+const Character* PersistentCharacterBST::search(const std::string& name) const {
+	const PersistentNode* node = root.get();
+	while (node) {
+		if (name == node->record->name) return node->record.get();
+		node = name < node->record->name ? node->left.get() : node->right.get();
+	}
+	return nullptr;
+}
+
+void PersistentCharacterBST::forEach(const std::function<void(const Character&)>& fn) const {
+	inorder(root.get(), fn);
+}
+
+std::vector<Character> PersistentCharacterBST::toVector() const {
+	std::vector<Character> all;
+	all.reserve(count);
+	forEach([&](const Character& c) { all.push_back(c); });
+	return all;
+}
+
+void PersistentCharacterBST::diff(const PersistentCharacterBST& older, const PersistentCharacterBST& newer,
+	const std::function<void(const CharacterChange&)>& fn) {
+	diffNodes(older.root, newer.root, fn);
+}
+
+//======================================
+//		Roster History
+//======================================
+void RosterHistory::tag(const std::string& label, const PersistentCharacterBST& version) {
+	versions[label] = version;
+}
+
+void RosterHistory::drop(const std::string& label) {
+	versions.erase(label);
+}
+
+const PersistentCharacterBST& RosterHistory::get(const std::string& label) const {
+	auto it = versions.find(label);
+	if (it == versions.end()) {
+		throw std::runtime_error("Version '" + label + "' not found.");
+	}
+	return it->second;
+}
+
+std::vector<std::string> RosterHistory::labels() const {
+	std::vector<std::string> all;
+	for (const auto& v : versions) all.push_back(v.first);
+	return all;
+}
+
+void RosterHistory::diff(const std::string& olderLabel, const std::string& newerLabel,
+	const std::function<void(const CharacterChange&)>& fn) const {
+	PersistentCharacterBST::diff(get(olderLabel), get(newerLabel), fn);
+}
+
+size_t RosterHistory::nodeCount() const {
+	std::unordered_set<const PersistentNode*> seen;
+	for (const auto& v : versions) collectNodes(v.second.getRoot().get(), seen);
+	return seen.size();
+}
@@ -0,0 +1,123 @@
+// ===========================================================
+// Capstone Project
+// CRUD Functionality - BST - SQLite - Html Report
+// Author: Austin Thompson
+// ------------------------------------------------------
+// Description: Immutable, path copying Binary Search Tree.
+// Every change returns a new version that shares all
+// untouched nodes with the old one, so versions are cheap
+// to keep and safe to read from any thread.
+//-------------------------------------------------------
+// ===========================================================
+
+#ifndef PERSISTENT_CHARACTER_BST_H
+#define PERSISTENT_CHARACTER_BST_H
+
+#include "Character.h"
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+//==================================
+// Persistent Node Structure
+// Never modified after construction,
+// records are shared between versions
+//==================================
+struct PersistentNode;
+typedef std::shared_ptr<const PersistentNode> PersistentNodePtr;
+
+struct PersistentNode {
+    std::shared_ptr<const Character> record;
+    PersistentNodePtr left;
+    PersistentNodePtr right;
+    uint64_t priority;      // Hash of the name, heap ordered
+
+    PersistentNode(std::shared_ptr<const Character> r, PersistentNodePtr l, PersistentNodePtr rt, uint64_t p)
+        : record(std::move(r)), left(std::move(l)), right(std::move(rt)), priority(p) {}
+};
+
+//==================================
+// Character Change
+// One difference between two versions
+//==================================
+struct CharacterChange {
+    enum Kind { Added, Removed, Changed };
+
+    Kind kind;
+    const Character* before;    // Null for Added
+    const Character* after;     // Null for Removed
+};
+
+//==================================
+// Persistent Character BST Class
+// Treap with priorities taken from the
+// name hash, so depth stays O(log n) and a
+// given set of names always has the same
+// shape. Copying a version is O(1), changes
+// copy only the O(log n) search path.
+//==================================
+class PersistentCharacterBST {
+private:
+    PersistentNodePtr root;
+    size_t count;
+
+    PersistentCharacterBST(PersistentNodePtr r, size_t n) : root(std::move(r)), count(n) {}
+
+public:
+    // Empty version
+    PersistentCharacterBST() : count(0) {}
+
+    // Version from records sorted by name with no duplicates, O(n)
+    static PersistentCharacterBST fromSorted(const std::vector<Character>& sorted);
+
+    // New versions, this one is left unchanged.
+    // Throw the same errors as CharacterBST for duplicates/missing keys.
+    // updated never renames, c.name must equal name.
+    PersistentCharacterBST inserted(const Character& c) const;
+    PersistentCharacterBST updated(const std::string& name, const Character& c) const;
+    PersistentCharacterBST removed(const std::string& name) const;
+
+    const Character* search(const std::string& name) const;
+    void forEach(const std::function<void(const Character&)>& fn) const;   //In order
+    std::vector<Character> toVector() const;
+
+    // Reports differences in name order. Subtrees shared by both
+    // versions are skipped, so cost follows the number of changes.
+    static void diff(const PersistentCharacterBST& older, const PersistentCharacterBST& newer,
+        const std::function<void(const CharacterChange&)>& fn);
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    const PersistentNodePtr& getRoot() const { return root; }
+};
+
+//==================================
+// Roster History Class
+// Named versions (one per game patch)
+// sharing nodes with each other
+//==================================
+class RosterHistory {
+private:
+    std::map<std::string, PersistentCharacterBST> versions;
+
+public:
+    // Stores or replaces a version under a label, O(1)
+    void tag(const std::string& label, const PersistentCharacterBST& version);
+    void drop(const std::string& label);
+
+    // Throws when the label is unknown
+    const PersistentCharacterBST& get(const std::string& label) const;
+    bool has(const std::string& label) const { return versions.count(label) != 0; }
+    std::vector<std::string> labels() const;
+
+    void diff(const std::string& olderLabel, const std::string& newerLabel,
+        const std::function<void(const CharacterChange&)>& fn) const;
+
+    // Distinct nodes held across every version, each one is stored once
+    size_t nodeCount() const;
+};
+
+#endif
@@ -0,0 +1,163 @@
+// ===========================================================
+// Capstone Project
+// CRUD Functionality - BST - SQLite - Html Report
+// Author: Austin Thompson
+// ------------------------------------------------------
+// Description: Character database split into independent
+// shards by name hash.
+//-------------------------------------------------------
+// ===========================================================
+
+#include "ShardedCharacterDatabase.h"
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+
+ShardedCharacterDatabase::ShardedCharacterDatabase(size_t shardCount) {
+	if (shardCount == 0) shardCount = 2 * std::max(1u, std::thread::hardware_concurrency());
+	for (size_t i = 0; i < shardCount; ++i) shards.emplace_back(new Shard());
+}
+
+size_t ShardedCharacterDatabase::shardIndex(const std::string& name) const {
+	return std::hash<std::string>()(name) % shards.size();
+}
+
+ShardedCharacterDatabase::Shard& ShardedCharacterDatabase::shardFor(const std::string& name) const {
+	return *shards[shardIndex(name)];
+}
+
+//======================================
+//		Loading
+//======================================
+void ShardedCharacterDatabase::loadFromDB(const std::string& dbFile) {
+	std::vector<Character> sorted = CharacterDatabase::readSortedParallel(dbFile);
+
+	// Sorted input stays sorted per shard
+	std::vector<std::vector<Character>> buckets(shards.size());
+	for (Character& c : sorted) {
+		buckets[shardIndex(c.name)].push_back(std::move(c));
+	}
+	sorted.clear();
+
+	std::vector<std::thread> threads;
+	std::vector<std::exception_ptr> errors(shards.size());
+	for (size_t i = 0; i < shards.size(); ++i) {
+		threads.emplace_back([&, i]() {
+			try {
+				std::unique_lock<std::shared_mutex> lock(shards[i]->lock);
+				CharacterBST& bst = shards[i]->bst;
+				if (bst.empty()) {
+					bst.buildFromSorted(buckets[i]);
+					return;
+				}
+				for (Character& c : buckets[i]) {
+					if (bst.tryInsert(std::move(c)) == CrudStatus::Duplicate) {
+						std::cerr << "Warning: Insert failed: Character with name '" << c.name
+							<< "' already exists. Skipping duplicate in BST.\n";
+					}
+				}
+			}
+			catch (...) {
+				errors[i] = std::current_exception();
+			}
+			});
+	}
+	for (auto& t : threads) t.join();
+	for (auto& e : errors) {
+		if (e) std::rethrow_exception(e);
+	}
+}
+
+//======================================
+//		Point Operations
+//======================================
+CrudStatus ShardedCharacterDatabase::tryAddCharacter(const Character& c) {
+	Shard& shard = shardFor(c.name);
+	std::unique_lock<std::shared_mutex> lock(shard.lock);
+	return shard.bst.tryInsert(c);
+}
+
+// Renames would move the record to another shard, so they are refused
+CrudStatus ShardedCharacterDatabase::tryUpdateCharacter(const std::string& name, const Character& c) {
+	if (c.name != name) return CrudStatus::Invalid;
+	Shard& shard = shardFor(name);
+	std::unique_lock<std::shared_mutex> lock(shard.lock);
+	return shard.bst.tryUpdate(name, c);
+}
+
+CrudStatus ShardedCharacterDatabase::tryDeleteCharacter(const std::string& name) {
+	Shard& shard = shardFor(name);
+	std::unique_lock<std::shared_mutex> lock(shard.lock);
+	return shard.bst.tryRemove(name);
+}
+
+// Messages are built only once a change failed
+void ShardedCharacterDatabase::addCharacter(const Character& c) {
+	if (tryAddCharacter(c) != CrudStatus::Ok) {
+		throw std::runtime_error("Insert failed: Character with name '" + c.name + "' already exists.");
+	}
+}
+
+void ShardedCharacterDatabase::updateCharacter(const std::string& name, const Character& c) {
+	CrudStatus status = tryUpdateCharacter(name, c);
+	if (status == CrudStatus::Invalid) {
+		throw std::runtime_error("Update failed: cannot rename '" + name + "' in a sharded database.");
+	}
+	if (status != CrudStatus::Ok) throw std::runtime_error("Update failed: Character '" + name + "' not found.");
+}
+
+void ShardedCharacterDatabase::deleteCharacter(const std::string& name) {
+	if (tryDeleteCharacter(name) != CrudStatus::Ok) {
+		throw std::runtime_error("Delete failed: Character '" + name + "' not found.");
+	}
+}
+
+std::optional<Character> ShardedCharacterDatabase::getCharacter(const std::string& name) const {
+	Shard& shard = shardFor(name);
+	std::shared_lock<std::shared_mutex> lock(shard.lock);
+	const Character* c = shard.bst.search(name);
+	if (!c) return std::nullopt;
+	return *c;
+}
+
+//======================================
+//		Ordered Scans
+//======================================
+void ShardedCharacterDatabase::forEachInOrder(const std::function<void(const Character&)>& fn) const {
+	// Copy every shard's sorted run while all shards are read locked,
+	// locks taken in index order so scans never deadlock each other
+	std::vector<std::vector<Character>> runs(shards.size());
+	{
+		std::vector<std::shared_lock<std::shared_mutex>> locks;
+		for (const auto& shard : shards) locks.emplace_back(shard->lock);
+		for (size_t i = 0; i < shards.size(); ++i) {
+			std::function<void(const Node*)> traverse = [&](const Node* node) {
+				if (!node) return;
+				traverse(node->left);
+				runs[i].push_back(node->data);
+				traverse(node->right);
+				};
+			traverse(shards[i]->bst.getRoot());
+		}
+	}
+
+	// Same merge as the parallel loader, names never repeat across shards
+	for (const Character& c : mergeSortedRuns(runs)) fn(c);
+}
+
+std::vector<Character> ShardedCharacterDatabase::getAllCharacters() const {
+	std::vector<Character> all;
+	forEachInOrder([&](const Character& c) { all.push_back(c); });
+	return all;
+}
+
+void ShardedCharacterDatabase::displayCharacters() const {
+	size_t shown = 0;
+	forEachInOrder([&](const Character& c) {
+		std::cout << "Character: " << c.name
+			<< " | Gun DPS: " << c.gunDPS
+			<< " | Health: " << c.health << std::endl;
+		++shown;
+		});
+	if (shown == 0) std::cout << "Database is empty." << std::endl;
+}
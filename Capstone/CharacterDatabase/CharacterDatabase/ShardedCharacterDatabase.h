@@ -0,0 +1,81 @@
+// ===========================================================
+// Capstone Project
+// CRUD Functionality - BST - SQLite - Html Report
+// Author: Austin Thompson
+// ------------------------------------------------------
+// Description: Character database split into independent
+// shards by name hash. Each shard has its own tree, lock
+// and node pool, so writers on different shards never
+// contend. Ordered scans merge the shards.
+//-------------------------------------------------------
+// ===========================================================
+
+#ifndef SHARDED_CHARACTER_DATABASE_H
+#define SHARDED_CHARACTER_DATABASE_H
+
+#include "Character.h"
+#include <functional>
+#include <memory>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+
+//==================================
+// Sharded Character Database Class
+//==================================
+class ShardedCharacterDatabase {
+private:
+    // Padded so neighbouring shard locks do not share a cache line
+    struct alignas(64) Shard {
+        mutable std::shared_mutex lock;
+        CharacterBST bst;
+    };
+
+    std::vector<std::unique_ptr<Shard>> shards;
+
+    Shard& shardFor(const std::string& name) const;
+
+public:
+    // 0 shards = two per core
+    explicit ShardedCharacterDatabase(size_t shardCount = 0);
+
+    // Decodes with the parallel loader, then builds every shard
+    // as a balanced tree on its own thread
+    void loadFromDB(const std::string& dbFile);
+
+    //Character functions, routed to one shard. Nothing is printed,
+    //so writers on different shards share no lock at all.
+    void addCharacter(const Character& c);
+    void updateCharacter(const std::string& name, const Character& c);
+    void deleteCharacter(const std::string& name);
+
+    // Same changes reporting Duplicate, NotFound or Invalid (a
+    // rename) instead of throwing
+    CrudStatus tryAddCharacter(const Character& c);
+    CrudStatus tryUpdateCharacter(const std::string& name, const Character& c);
+    CrudStatus tryDeleteCharacter(const std::string& name);
+    std::optional<Character> getCharacter(const std::string& name) const;
+
+    // Runs fn on the record under its shard's read lock
+    template <typename Fn>
+    bool withCharacter(const std::string& name, Fn fn) const {
+        Shard& shard = shardFor(name);
+        std::shared_lock<std::shared_mutex> lock(shard.lock);
+        const Character* c = shard.bst.search(name);
+        if (!c) return false;
+        fn(*c);
+        return true;
+    }
+
+    // Ordered scans: every shard is read under its lock at
+    // the same time, then the sorted runs are k-way merged
+    void forEachInOrder(const std::function<void(const Character&)>& fn) const;
+    std::vector<Character> getAllCharacters() const;
+    void displayCharacters() const;
+
+    size_t shardCount() const { return shards.size(); }
+    size_t shardIndex(const std::string& name) const;
+};
+
+#endif
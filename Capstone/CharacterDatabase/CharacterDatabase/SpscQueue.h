@@ -0,0 +1,77 @@
+// ===========================================================
+// Capstone Project
+// CRUD Functionality - BST - SQLite - Html Report
+// Author: Austin Thompson
+// ------------------------------------------------------
+// Description: Bounded lock free queue connecting one
+// producer thread to one consumer thread. Used by the
+// pipelined loader to hand decoded batches to the tree.
+//-------------------------------------------------------
+// ===========================================================
+
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <utility>
+#include <vector>
+
+//==================================
+// Single Producer Single Consumer Queue
+// Ring buffer with one slot kept free,
+// head owned by consumer, tail by producer
+//==================================
+template <typename T>
+class SpscQueue {
+private:
+    std::vector<T> slots;
+    size_t mask;
+
+    // Separate cache lines so producer and consumer do not false share
+    alignas(64) std::atomic<size_t> head;
+    alignas(64) std::atomic<size_t> tail;
+
+public:
+    // Capacity is rounded up to a power of two
+    explicit SpscQueue(size_t capacity) : head(0), tail(0) {
+        size_t size = 2;
+        while (size < capacity + 1) size <<= 1;
+        slots.resize(size);
+        mask = size - 1;
+    }
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    // Producer only, returns false when full
+    bool tryPush(T& item) {
+        size_t t = tail.load(std::memory_order_relaxed);
+        size_t next = (t + 1) & mask;
+        if (next == head.load(std::memory_order_acquire)) return false;
+        slots[t] = std::move(item);
+        tail.store(next, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer only, returns false when empty
+    bool tryPop(T& item) {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (h == tail.load(std::memory_order_acquire)) return false;
+        item = std::move(slots[h]);
+        head.store((h + 1) & mask, std::memory_order_release);
+        return true;
+    }
+
+    // Blocking variants, yield while the other side catches up
+    void push(T& item) {
+        while (!tryPush(item)) std::this_thread::yield();
+    }
+
+    void pop(T& item) {
+        while (!tryPop(item)) std::this_thread::yield();
+    }
+};
+
+#endif
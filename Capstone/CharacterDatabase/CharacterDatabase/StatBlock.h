@@ -0,0 +1,133 @@
+// ===========================================================
+// Capstone Project
+// CRUD Functionality - BST - SQLite - Html Report
+// Author: Austin Thompson
+// ------------------------------------------------------
+// Description: Seqlock protected copy of one character's
+// numeric stats. Writers bump the version to odd, store
+// the words and bump it back to even; readers copy the
+// words and retry if the version moved, so a read never
+// takes a lock and never returns a half written record.
+//-------------------------------------------------------
+// ===========================================================
+
+#ifndef STAT_BLOCK_H
+#define STAT_BLOCK_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <thread>
+
+//==================================
+// Character Stats
+// Numeric part of a Character
+//==================================
+struct CharacterStats {
+    int gunDPS;
+    float bulletDMG;
+    int ammo;
+    float bulletSpeed;
+    int lightMeleeDMG;
+    int heavyMeleeDMG;
+    int health;
+    float regen;
+    float bulletResist;
+    float spiritResist;
+    float speed;
+    float sprint;
+    int stamina;
+};
+
+//==================================
+// Stat Block Class
+//==================================
+class StatBlock {
+private:
+    static const size_t statWords = sizeof(CharacterStats) / sizeof(uint32_t);
+    static_assert(sizeof(CharacterStats) == statWords * sizeof(uint32_t), "stats must be whole 32 bit words");
+
+    std::atomic<uint32_t> version{ 0 };                 //Odd while a write is in progress
+    std::atomic<uint32_t> present{ 0 };                 //0 once the record is deleted
+    std::atomic<uint32_t> words[statWords] = {};
+
+public:
+    // Holds the block for one write, concurrent writers queue on the version
+    class Writer {
+    private:
+        StatBlock& block;
+    public:
+        explicit Writer(StatBlock& block) : block(block) {
+            uint32_t v = block.version.load(std::memory_order_relaxed);
+            while ((v & 1) || !block.version.compare_exchange_weak(v, v + 1, std::memory_order_acquire)) {
+                if (v & 1) {
+                    std::this_thread::yield();
+                    v = block.version.load(std::memory_order_relaxed);
+                }
+            }
+            std::atomic_thread_fence(std::memory_order_release);
+        }
+        ~Writer() { block.version.fetch_add(1, std::memory_order_release); }
+        Writer(const Writer&) = delete;
+        Writer& operator=(const Writer&) = delete;
+
+        // Null marks the record as deleted
+        void set(const CharacterStats* stats) {
+            if (stats) {
+                uint32_t raw[statWords];
+                std::memcpy(raw, stats, sizeof(raw));
+                for (size_t i = 0; i < statWords; ++i) block.words[i].store(raw[i], std::memory_order_relaxed);
+            }
+            block.present.store(stats ? 1 : 0, std::memory_order_relaxed);
+        }
+    };
+
+    // Optimistic copy, false if the record is deleted
+    bool read(CharacterStats& out, uint32_t* readVersion = nullptr) const {
+        uint32_t raw[statWords];
+        uint32_t v, isPresent;
+        while (true) {
+            v = version.load(std::memory_order_acquire);
+            if (v & 1) {
+                std::this_thread::yield();
+                continue;
+            }
+            for (size_t i = 0; i < statWords; ++i) raw[i] = words[i].load(std::memory_order_relaxed);
+            isPresent = present.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (version.load(std::memory_order_relaxed) == v) break;
+        }
+        if (readVersion) *readVersion = v;
+        if (!isPresent) return false;
+        std::memcpy(&out, raw, sizeof(out));
+        return true;
+    }
+
+    // Changes on every write, even once the write is done
+    uint32_t currentVersion() const { return version.load(std::memory_order_acquire); }
+};
+
+//==================================
+// Stat Handle
+// Reader side of one record's block,
+// stays valid after the record is gone
+//==================================
+class StatHandle {
+private:
+    std::shared_ptr<const StatBlock> block;
+
+public:
+    StatHandle() {}
+    explicit StatHandle(std::shared_ptr<const StatBlock> block) : block(std::move(block)) {}
+
+    bool valid() const { return block != nullptr; }
+    bool read(CharacterStats& out) const { return block && block->read(out); }
+    uint32_t version() const { return block ? block->currentVersion() : 0; }
+
+    // Single stat shortcuts, 0 once the record is deleted
+    int health() const { CharacterStats s; return read(s) ? s.health : 0; }
+    int gunDPS() const { CharacterStats s; return read(s) ? s.gunDPS : 0; }
+};
+
+#endif
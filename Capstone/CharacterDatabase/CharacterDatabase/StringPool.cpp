@@ -0,0 +1,66 @@
+// ===========================================================
+// Capstone Project
+// CRUD Functionality - BST - SQLite - Html Report
+// Author: Austin Thompson
+// ------------------------------------------------------
+// Description: Interning pool for repeated text.
+//-------------------------------------------------------
+// ===========================================================
+
+#include "StringPool.h"
+#include <stdexcept>
+
+StringPool::StringPool() {
+	clear();
+}
+
+StringId StringPool::intern(const std::string& text) {
+	auto it = ids.find(text);
+	if (it != ids.end()) {
+		++refs[it->second];
+		return it->second;
+	}
+
+	StringId id;
+	if (!freeIds.empty()) {
+		id = freeIds.back();
+		freeIds.pop_back();
+		texts[id] = text;
+		refs[id] = 1;
+	}
+	else {
+		if (texts.size() >= UINT32_MAX) {
+			throw std::runtime_error("Intern failed: string pool is full.");
+		}
+		id = static_cast<StringId>(texts.size());
+		texts.push_back(text);
+		refs.push_back(1);
+	}
+	ids.emplace(texts[id], id);
+	return id;
+}
+
+StringId StringPool::reintern(StringId id, const std::string& text) {
+	if (texts[id] == text) return id;
+	StringId next = intern(text);
+	release(id);
+	return next;
+}
+
+// The empty string is never dropped
+void StringPool::release(StringId id) {
+	if (id == 0 || --refs[id] != 0) return;
+	ids.erase(texts[id]);
+	std::string().swap(texts[id]);
+	freeIds.push_back(id);
+}
+
+void StringPool::clear() {
+	ids.clear();
+	texts.clear();
+	refs.clear();
+	freeIds.clear();
+	texts.emplace_back();
+	refs.push_back(0);
+	ids.emplace(texts.back(), 0);
+}
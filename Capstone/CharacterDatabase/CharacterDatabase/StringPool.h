@@ -0,0 +1,60 @@
+// ===========================================================
+// Capstone Project
+// CRUD Functionality - BST - SQLite - Html Report
+// Author: Austin Thompson
+// ------------------------------------------------------
+// Description: Interning pool for text that repeats across
+// records, such as ability names. Each distinct string is
+// stored once and records keep a 32 bit id, so two texts from
+// the same pool are equal exactly when their ids are.
+// Ids are reference counted so rows that go away give
+// their text back.
+//-------------------------------------------------------
+// ===========================================================
+
+#ifndef STRING_POOL_H
+#define STRING_POOL_H
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+typedef uint32_t StringId;
+
+//==================================
+// String Pool Class
+// Every intern holds one reference
+// until released; a string with none
+// left is dropped and its id reused.
+// Id 0 is always the empty string.
+//==================================
+class StringPool {
+private:
+    std::deque<std::string> texts;                      //By id, a deque so the map's views never move
+    std::unordered_map<std::string_view, StringId> ids;
+    std::vector<uint32_t> refs;                         //By id, interns not yet released
+    std::vector<StringId> freeIds;                      //Released ids, reused before texts grows
+
+public:
+    StringPool();
+
+    StringPool(const StringPool&) = delete;
+    StringPool& operator=(const StringPool&) = delete;
+
+    // Id of text, added on first sight. Takes a reference.
+    StringId intern(const std::string& text);
+    // Swaps id's reference for one to text, keeping id
+    // when it already names text to save the hash lookup
+    StringId reintern(StringId id, const std::string& text);
+    // Drops one reference taken by intern
+    void release(StringId id);
+
+    const std::string& text(StringId id) const { return texts[id]; }
+    size_t size() const { return texts.size() - freeIds.size(); }
+    void clear();
+};
+
+#endif
@@ -12,6 +12,7 @@
 // ===========================================================
 
 #include "Character.h"
+#include "PersistentCharacterBST.h"
 #include <iostream>
 #include <sqlite3.h>
 #include <fstream>
@@ -26,8 +27,9 @@ void exportToHTML(CharacterDatabase& db, const std::string& filename) {
     std::ofstream file(filename);
     if (!file.is_open()) throw std::runtime_error("Cannot open HTML file for writing");
 
-    //Retrieve all characters from the database
-    auto characters = db.getAllCharacters();
+    //Retrieve all characters from a consistent snapshot so live
+    //writers are neither blocked nor seen half applied
+    auto characters = db.snapshot()->toVector();
     //Exit if it is empty
     if (characters.empty()) return;
 
@@ -126,10 +128,8 @@ int main() {
 
         // Searches for character and updates its health value
         std::cout << "\n=== Update Pocket ===" << std::endl;
-        if (found) {
-            Character updated = *found;
-            updated.health = 2000;
-            db.updateCharacter("Pocket", updated);
+        if (db.patchCharacter("Pocket", [](Character& c) { c.health = 2000; }, CharacterField::Health) == CrudStatus::Ok) {
+            std::cout << "updated: Pocket" << std::endl;
         }
         
         // Deletes a character from list